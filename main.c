@@ -6,10 +6,154 @@
 //
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <sys/stat.h>
 #include "telecmd_interpreter.h"
 
+/* Append path to the list, FALSE if memory is not available */
+static BOOL appendFilePath(char *pFilePath, char ***pppFilePaths, UINT32 *pNumOfFiles)
+{
+    char **ppNewFilePaths = realloc(*pppFilePaths, (*pNumOfFiles + 1) * sizeof(char *));
+
+    if (ppNewFilePaths == NULL)
+    {
+        printf("ERROR: Failed to assign dynamic memory for batch file list\n");
+        return FALSE;
+    }
+    *pppFilePaths = ppNewFilePaths;
+    (*pppFilePaths)[(*pNumOfFiles)++] = pFilePath;
+    return TRUE;
+}
+
+/* Add the batch file, or all regular files of a directory in name order.
+ * FALSE if memory is not available, files added so far stay in the list */
+static BOOL addBatchFilePaths(const char *pPath, char ***pppFilePaths, UINT32 *pNumOfFiles)
+{
+    struct stat pathStat;
+    struct dirent **ppDirEntries = NULL;
+    const char *pSeparator = "/";
+    char *pFilePath = NULL;
+    BOOL isAdded = TRUE;
+    int numOfEntries = 0;
+    int entryIdx = 0;
+
+    if ((stat(pPath, &pathStat) != 0) || !S_ISDIR(pathStat.st_mode))
+    {
+        /* Not a directory, interpreter reports it if it can not be opened */
+        pFilePath = strdup(pPath);
+        if (pFilePath == NULL)
+        {
+            printf("ERROR: Failed to assign dynamic memory for batch file path\n");
+            return FALSE;
+        }
+        if (appendFilePath(pFilePath, pppFilePaths, pNumOfFiles) == FALSE)
+        {
+            free(pFilePath);
+            return FALSE;
+        }
+        return TRUE;
+    }
+
+    if (pPath[strlen(pPath) - 1] == '/')
+    {
+        pSeparator = "";
+    }
+
+    numOfEntries = scandir(pPath, &ppDirEntries, NULL, alphasort);
+    for (entryIdx = 0; entryIdx < numOfEntries; entryIdx++)
+    {
+        size_t sizeOfPath = strlen(pPath) + strlen(pSeparator) + strlen(ppDirEntries[entryIdx]->d_name) + 1;
+
+        pFilePath = NULL;
+        if ((isAdded == TRUE) && (ppDirEntries[entryIdx]->d_name[0] != '.'))
+        {
+            pFilePath = malloc(sizeOfPath);
+            if (pFilePath == NULL)
+            {
+                printf("ERROR: Failed to assign dynamic memory for batch file path\n");
+                isAdded = FALSE;
+            }
+        }
+
+        if (pFilePath != NULL)
+        {
+            snprintf(pFilePath, sizeOfPath, "%s%s%s", pPath, pSeparator, ppDirEntries[entryIdx]->d_name);
+            if ((stat(pFilePath, &pathStat) != 0) || !S_ISREG(pathStat.st_mode))
+            {
+                free(pFilePath);
+            }
+            else if (appendFilePath(pFilePath, pppFilePaths, pNumOfFiles) == FALSE)
+            {
+                free(pFilePath);
+                isAdded = FALSE;
+            }
+        }
+        free(ppDirEntries[entryIdx]);
+    }
+    free(ppDirEntries);
+    return isAdded;
+}
+
 int main(int argc, const char * argv[])
 {
+    char **ppFilePaths = NULL;
+    UINT32 numOfFiles = 0;
+    BOOL isMergeRequired = FALSE;
+    int argIdx = 1;
+
+    /* Ground station front end can hand over commands through shared
+     * memory ring instead of batch file: telecmdAppl --shm /ringName */
+    if ((argc == 3) && (strcmp(argv[1], "--shm") == 0))
+    {
+        return (telecmdInterpreterShmRing(argv[2]) == TRUE) ? 0 : 1;
+    }
+
+    /* Many batch files or directories, each file gets its own queue:
+     * telecmdAppl [--merge] <file|dir>... */
+    if ((argc > 1) && (strcmp(argv[1], "--merge") == 0))
+    {
+        isMergeRequired = TRUE;
+        argIdx++;
+        if (argIdx == argc)
+        {
+            printf("ERROR: --merge needs at least one batch file or directory\n");
+            return 1;
+        }
+    }
+    if (argIdx < argc)
+    {
+        BOOL isListComplete = TRUE;
+        int exitCode = 0;
+
+        for (; (argIdx < argc) && (isListComplete == TRUE); argIdx++)
+        {
+            isListComplete = addBatchFilePaths(argv[argIdx], &ppFilePaths, &numOfFiles);
+        }
+
+        if (isListComplete == FALSE)
+        {
+            exitCode = 1;
+        }
+        else if (numOfFiles == 0)
+        {
+            printf("ERROR: No telecommand batch file found\n");
+            exitCode = 1;
+        }
+        else if (telecmdInterpreterFiles((const CHAR **) ppFilePaths, numOfFiles, isMergeRequired) == FALSE)
+        {
+            exitCode = 1;
+        }
+
+        while (numOfFiles > 0)
+        {
+            free(ppFilePaths[--numOfFiles]);
+        }
+        free(ppFilePaths);
+        return exitCode;
+    }
+
     /* After Receving Command Batch file from ground station,
      * telecmdInterpreter will handle it for further process. */
     telecmdInterpreter();
@@ -12,9 +12,15 @@
 /* System includes */
 #include <string.h>
 #include <stdlib.h>
+#include <sched.h>
+#include <time.h>
+#include <pthread.h>
+#include <errno.h>
 
 /* Custom includes */
 #include "telecmd_interpreter.h"
+#include "telecmd_shm_ring.h"
+#include "telecmd_thread_pool.h"
 
 /* Defines and Data Types */
 #define TELECMD_FILE "CMD.bat"
@@ -22,17 +28,147 @@
 #define MAX_LENGTH      256
 #define INVALID_VAL     0
 
+/* Tombstone deletion: deleted nodes are only marked and skipped by
+ * traversals, a compaction pass unlinks and frees them in bulk. Off by
+ * default, lookup of a DELETE target walks the Queue anyway and unlink is
+ * O(1), so tombstones only make the later lookups longer */
+#ifndef TOMBSTONE_DELETE_MODE
+#define TOMBSTONE_DELETE_MODE   FALSE
+#endif
+#define TOMBSTONE_COMPACT_PCT   25  /* compact when tombstones exceed this % */
+
+/* Empty shared memory ring: yield for a while, then sleep with growing
+ * backoff and check that producer is still alive */
+#define SHM_POLL_SPIN_COUNT         64      /* yielding polls before sleeping */
+#define SHM_POLL_MIN_SLEEP_NSEC     10000   /* first sleep, 10 us */
+#define SHM_POLL_MAX_SLEEP_NSEC     1000000 /* longest sleep, 1 ms */
+#define SHM_ATTACH_TIMEOUT_MSEC     5000    /* wait for producer to create ring */
+
+/* Entry of bounded heap used to select K most urgent commands */
+typedef struct
+{
+    TELE_CMD_LIST_t     *pCmdNode;      /* Selected command node */
+    UINT32              queuePos;       /* Position in Queue, orders the ties */
+}TOP_K_ENTRY_t;
+
+/* Parallel execution: commands linked by targetIdx form a group which is
+ * executed in Queue order by one task, different groups run in parallel */
+#ifndef PARALLEL_EXEC_MIN_CMDS
+#define PARALLEL_EXEC_MIN_CMDS      1024 /* smaller Queue runs sequentially */
+#endif
+#define PARALLEL_TASKS_PER_WORKER   8    /* tasks per worker for balancing */
+#define INVALID_POS                 0xFFFFFFFFu
+#define ENTRY_POS_HASH_MUL          2654435761u /* Knuth multiplicative hash */
+
+/* Slot of open addressing table mapping entry Idx to Queue position */
+typedef struct
+{
+    UINT32              entryIdx;       /* entry Idx of the node */
+    UINT32              queuePos;       /* first position, INVALID_POS if slot free */
+    UINT32              lastPos;        /* last position with same entry Idx */
+}ENTRY_POS_SLOT_t;
+
+/* Result of command in parallel execution, reported after join */
+typedef enum
+{
+    EXEC_RESULT_OK = 0,
+    EXEC_RESULT_NODE_NOT_FOUND,
+    EXEC_RESULT_INVALID_CMD,
+}EXEC_RESULT_e;
+
+/* Shared data of one parallel execution */
+typedef struct
+{
+    TELE_CMD_LIST_t     **ppCmdNodes;   /* live nodes in Queue order */
+    ENTRY_POS_SLOT_t    *pEntryPosSlots;/* entryIdx to position in ppCmdNodes */
+    UINT32              entryPosMask;   /* slots - 1, slots is power of 2 */
+    UINT32              *pNextSamePos;  /* next position with same entry Idx */
+    UINT32              *pGroupStart;   /* first member of each group */
+    UINT32              *pGroupMembers; /* positions, grouped, Queue order */
+    BOOL                *pIsAlive;      /* not executed and not deleted yet */
+    UINT8               *pExecResult;   /* EXEC_RESULT_e per position */
+}PARALLEL_EXEC_CTX_t;
+
+/* Array sort: nodes are copied to an array, segments are sorted per
+ * worker and then merged pairwise, each merge split by merge path */
+#ifndef PARALLEL_SORT_MIN_CMDS
+#define PARALLEL_SORT_MIN_CMDS      4096 /* smaller Queue sorts on one worker */
+#endif
+
+/* Task of parallel sort, one output range of merging two sorted runs */
+typedef struct
+{
+    TELE_CMD_LIST_t     **ppSrcNodes;   /* array holding the sorted runs */
+    TELE_CMD_LIST_t     **ppDstNodes;   /* array receiving merged run */
+    UINT32              firstBegin;     /* first run is [firstBegin, firstEnd) */
+    UINT32              firstEnd;       /* second run is [firstEnd, secondEnd) */
+    UINT32              secondEnd;
+    UINT32              diagBegin;      /* output range of this task, */
+    UINT32              diagEnd;        /* relative to firstBegin */
+}PARALLEL_MERGE_TASK_t;
+
+/* Task of parallel execution, a range of groups */
+typedef struct
+{
+    PARALLEL_EXEC_CTX_t *pExecCtx;      /* shared data */
+    UINT32              firstGroup;     /* first group of the task */
+    UINT32              endGroup;       /* one after last group of the task */
+}PARALLEL_EXEC_TASK_t;
+
+/* One batch file processed into its own Queue shard */
+typedef struct cmdShard
+{
+    const CHAR          *pFilePath;     /* batch file of the shard */
+    CHARPTR             pOutput;        /* output printed by the shard */
+    size_t              sizeOfOutput;   /* length of pOutput */
+    UINT32              numOfCmdLines;  /* lines read from batch file */
+    UINT32              numOfQueuedCmds;/* commands left in Queue at EOF */
+    UINT64              elapsedUsec;    /* processing time of the shard */
+    TELE_CMD_LIST_t     *pQueueHead;    /* sorted leftover Queue for merge */
+    BOOL                isMergeRequired;/* keep leftover Queue for merge */
+    BOOL                isFileRead;     /* batch file could be opened */
+    BOOL                isDone;         /* shard finished, output complete */
+    struct cmdShardRun  *pShardRun;     /* run the shard belongs to */
+}CMD_SHARD_t;
+
+/* Shards of one multi file run, reported in file order as they finish */
+typedef struct cmdShardRun
+{
+    CMD_SHARD_t         *pShards;       /* shards in file order */
+    UINT32              numOfShards;    /* number of shards */
+    UINT32              nextReportIdx;  /* first shard not reported yet */
+    UINT32              numOfCmdLines;  /* lines of reported shards */
+    UINT32              numOfFailedFiles;/* reported shards not read */
+    FILE                *pReportFile;   /* output of submitting thread */
+    pthread_mutex_t     reportLock;     /* protects report state and order */
+}CMD_SHARD_RUN_t;
+
+/* Global Variables */
+__thread FILE *pTeleCmdOutFile = NULL; /* Output of shard, NULL for stdout */
+
 /* Static Variables */
-static UINT32 nodeEntryIdx; /* Unique Idx for nodes of TeleCommand Queue */
-static TELE_CMD_LIST_t *pHeadTeleCmdQ      = NULL; /* Head of the Queue */
+/* Queue state is per thread, so every shard thread has its own Queue */
+static __thread UINT32 nodeEntryIdx; /* Unique Idx for nodes of TeleCommand Queue */
+static __thread TELE_CMD_LIST_t *pHeadTeleCmdQ      = NULL; /* Head of the Queue */
+static __thread UINT32 queueNodeCount; /* Nodes linked in Queue, tombstones included */
+static __thread UINT32 tombstoneCount; /* Nodes marked as deleted but still linked */
+static __thread BOOL isTombstoneModeOn = TOMBSTONE_DELETE_MODE; /* Deletion mode */
 
 /* Pointer for sorting the list */
-static TELE_CMD_LIST_t *pFirstHandlerPtr   = NULL; /* First list pointer */
-static TELE_CMD_LIST_t *pFirstEndPtr       = NULL; /* First list end pointer */
-static TELE_CMD_LIST_t *pSecondHandlerPtr  = NULL; /* Second list pointer */
-static TELE_CMD_LIST_t *pSecondEndPtr      = NULL; /* Second end pointer */
+static __thread TELE_CMD_LIST_t *pFirstHandlerPtr   = NULL; /* First list pointer */
+static __thread TELE_CMD_LIST_t *pFirstEndPtr       = NULL; /* First list end pointer */
+static __thread TELE_CMD_LIST_t *pSecondHandlerPtr  = NULL; /* Second list pointer */
+static __thread TELE_CMD_LIST_t *pSecondEndPtr      = NULL; /* Second end pointer */
 
 /* Function Prototypes */
+static BOOL interpretCmdFile(const CHAR *pFilePath, UINT32 *pNumOfCmdLines);
+static VOID runShardTask(VOIDPTR pTaskArg);
+static VOID reportFinishedShards(CMD_SHARD_t *pShard);
+static VOID printMergedShardQueues(CMD_SHARD_t *pShards, UINT32 numOfShards);
+static VOID siftDownShardHeap(TOP_K_ENTRY_t *pShardHeap, UINT32 heapSize, UINT32 heapIdx);
+static VOID freeCmdQueue(VOID);
+static TELECMD_SHM_RING_t *attachCmdShmRing(const CHAR *pRingName);
+static VOID processTeleCmd(TELECMD_CONFIG_t *pRcvdTeleCmdData);
 static VOID addNewCmdDataIntoQueue(TELECMD_CONFIG_t *pRcvdTeleCmdData);
 static VOID deleteCmdDataFromQueue(UINT32 refEntryIdx);
 static VOID sortTeleCmdQueue(VOID);
@@ -43,15 +179,37 @@ static VOID modifyCmdDataInQueue(UINT32 refEntryIdx, UINT32 refNewData);
 static VOID printCmdDataQueue(VOID);
 static VOID reverseCmdQueue(VOID);
 static VOID executeCmdFromQueue(VOID);
+static VOID removeNodeFromQueue(TELE_CMD_LIST_t *pDelNode);
+static VOID unlinkNodeFromQueue(TELE_CMD_LIST_t *pDelNode);
+static BOOL isCompactionRequired(VOID);
+static VOID compactCmdQueue(VOID);
+static VOID printCmdNode(const TELE_CMD_LIST_t *pCmdNode);
+static VOID executeCmdNode(TELE_CMD_LIST_t *pCmdNode);
+static VOID printTopKCmdsFromQueue(UINT32 topCount);
+static VOID executeTopKCmdsFromQueue(UINT32 topCount);
+static UINT32 selectTopKCmdNodes(UINT32 topCount, TOP_K_ENTRY_t **ppTopKEntries);
+static BOOL isLessUrgentEntry(const TOP_K_ENTRY_t *pEntryA, const TOP_K_ENTRY_t *pEntryB);
+static VOID siftDownTopKHeap(TOP_K_ENTRY_t *pTopKHeap, UINT32 heapSize, UINT32 heapIdx);
+static VOID executeCmdQueueParallel(VOID);
+static UINT32 buildCmdGroups(PARALLEL_EXEC_CTX_t *pExecCtx, UINT32 numOfCmds,
+                             UINT32 *pGroupParent, UINT32 *pGroupOfPos);
+static UINT32 findCmdGroupRoot(UINT32 *pGroupParent, UINT32 queuePos);
+static VOID joinCmdGroups(UINT32 *pGroupParent, UINT32 firstPos, UINT32 secondPos);
+static VOID addCmdEntryPos(PARALLEL_EXEC_CTX_t *pExecCtx, UINT32 entryIdx, UINT32 queuePos);
+static UINT32 getCmdTargetPos(const PARALLEL_EXEC_CTX_t *pExecCtx, UINT32 targetIdx);
+static VOID runParallelExecTask(VOIDPTR pTaskArg);
+static BOOL sortTeleCmdQueueParallel(UINT32 lenOfQueue, UINT32 numOfWorkers);
+static VOID runSegmentSortTask(VOIDPTR pTaskArg);
+static VOID runMergePathTask(VOIDPTR pTaskArg);
+static UINT32 findMergePathSplit(TELE_CMD_LIST_t **ppSrcNodes, UINT32 firstBegin,
+                                 UINT32 firstEnd, UINT32 secondEnd, UINT32 diagIdx);
 
 /* Function Definitions */
 
 /*------------------------------------------------------------------------------
  * FUNCTION: telecmdInterpreter()
  *------------------------------------------------------------------------------
- * ABSTRACT: This Function will read data from batch file, parse it,
- *           check the command type and based on type it will execute it
- *           or add into queue.
+ * ABSTRACT: This Function will interpret the default batch file.
  *------------------------------------------------------------------------------
  * PARAMETERS:
  *             IN:    None
@@ -62,15 +220,107 @@ static VOID executeCmdFromQueue(VOID);
  *
  *----------------------------------------------------------------------------*/
 VOID telecmdInterpreter(VOID)
+{
+    UINT32 numOfCmdLines = INVALID_VAL; /* lines read from batch file */
+    
+    interpretCmdFile(TELECMD_FILE, &numOfCmdLines);
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: telecmdInterpreterFiles()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This Function will interpret many batch files concurrently. Each
+ *           file is processed by a pool task into its own Queue shard, with
+ *           its own entry Idx space and output. Output of every file is
+ *           printed in given order, with lines read, commands left in Queue
+ *           and processing time, as soon as the file and all files before
+ *           it are done. Optionally the leftover Queues are merged by
+ *           priority and printed.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *             IN:    Batch file paths, number of files, merge flag
+ *             OUT:   None
+ * RETURN VALUE: TRUE if every file was read, FALSE otherwise
+ *------------------------------------------------------------------------------
+ * GLOBALS: -
+ *
+ *----------------------------------------------------------------------------*/
+BOOL telecmdInterpreterFiles(const CHAR **ppFilePaths, UINT32 numOfFiles, BOOL isMergeRequired)
+{
+    CMD_SHARD_t *pShards = (CMD_SHARD_t *) calloc(numOfFiles, sizeof(CMD_SHARD_t));
+    TELECMD_TASK_t *pPoolTasks = (TELECMD_TASK_t *) malloc(numOfFiles * sizeof(TELECMD_TASK_t));
+    CMD_SHARD_RUN_t shardRun = {pShards, numOfFiles, INVALID_VAL, INVALID_VAL, INVALID_VAL,
+                                TELECMD_OUT, PTHREAD_MUTEX_INITIALIZER}; /* report state */
+    struct timespec startTime; /* start of whole batch */
+    struct timespec endTime; /* end of whole batch */
+    UINT32 shardIdx = INVALID_VAL; /* loop var for shards */
+    
+    if ((pShards == NULL) || (pPoolTasks == NULL))
+    {
+        fprintf(TELECMD_OUT, "ERROR: Failed to assign dynamic memory for shards\n");
+        free(pShards);
+        free(pPoolTasks);
+        return FALSE;
+    }
+    
+    clock_gettime(CLOCK_MONOTONIC, &startTime);
+    for (shardIdx = 0; shardIdx < numOfFiles; shardIdx++)
+    {
+        pShards[shardIdx].pFilePath = ppFilePaths[shardIdx];
+        pShards[shardIdx].isMergeRequired = isMergeRequired;
+        pShards[shardIdx].pShardRun = &shardRun;
+        pPoolTasks[shardIdx].pTaskFn = runShardTask;
+        pPoolTasks[shardIdx].pTaskArg = &pShards[shardIdx];
+    }
+    /* Shards are reported by the tasks themselves as they finish */
+    telecmdPoolRunTasks(pPoolTasks, numOfFiles, telecmdPoolGetNumOfWorkers());
+    clock_gettime(CLOCK_MONOTONIC, &endTime);
+    pthread_mutex_destroy(&shardRun.reportLock);
+    
+    fprintf(TELECMD_OUT, "==== %u files, %u lines, %.3f ms ====\n", numOfFiles, shardRun.numOfCmdLines,
+            ((double) (endTime.tv_sec - startTime.tv_sec) * 1000.0) +
+            ((double) (endTime.tv_nsec - startTime.tv_nsec) / 1000000.0));
+    if (shardRun.numOfFailedFiles != INVALID_VAL)
+    {
+        fprintf(TELECMD_OUT, "ERROR: %u of %u files could not be read\n", shardRun.numOfFailedFiles, numOfFiles);
+    }
+    
+    if (isMergeRequired == TRUE)
+    {
+        printMergedShardQueues(pShards, numOfFiles);
+    }
+    
+    free(pShards);
+    free(pPoolTasks);
+    return (shardRun.numOfFailedFiles == INVALID_VAL) ? TRUE : FALSE;
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: interpretCmdFile()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This Function will read data from batch file, parse it,
+ *           check the command type and based on type it will execute it
+ *           or add into queue.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *             IN:    Path of batch file
+ *             OUT:   Number of lines read
+ * RETURN VALUE: TRUE if file is read, FALSE if it could not be opened
+ *------------------------------------------------------------------------------
+ * GLOBALS: -
+ *
+ *----------------------------------------------------------------------------*/
+static BOOL interpretCmdFile(const CHAR *pFilePath, UINT32 *pNumOfCmdLines)
 {
     FILE *pCmdFile              = NULL;          /* Pointer to cmd batch file */
     CHAR cmdBuffer[MAX_LENGTH]  = {INVALID_VAL}; /* Buffer to read commands */
     
-    pCmdFile = fopen(TELECMD_FILE, "r");
+    *pNumOfCmdLines = INVALID_VAL;
+    pCmdFile = fopen(pFilePath, "r");
     if(pCmdFile == NULL)
     {
-        printf("ERROR: Failed to open telecommand file\n");
-        return;
+        fprintf(TELECMD_OUT, "ERROR: Failed to open telecommand file\n");
+        return FALSE;
     }
     
     /* Read line by line until EOF */
@@ -79,6 +329,8 @@ VOID telecmdInterpreter(VOID)
         TELECMD_CONFIG_t parseCmdData = {INVALID_VAL}; /* store parsed values */
         UINT32 lenghtOfCmd = (UINT32) strlen(cmdBuffer); /* lenght of command */
         
+        (*pNumOfCmdLines)++;
+
         cmdBuffer[lenghtOfCmd-1] = '\0';
         /* Parse command id and check the type (utility or telecommand) */
         sscanf(cmdBuffer, "%u", &parseCmdData.teleCmd);
@@ -89,8 +341,6 @@ VOID telecmdInterpreter(VOID)
                 /* Parse the command values from buffer */
                 sscanf(cmdBuffer, "%u %u",  &parseCmdData.teleCmd,
                                             &parseCmdData.cmdData);
-                /* Add command data into Queue */
-                addNewCmdDataIntoQueue(&parseCmdData);
                 break;
             
             case CMD_NEWCMD_WITH_USER_PRIO:
@@ -98,16 +348,12 @@ VOID telecmdInterpreter(VOID)
                 sscanf(cmdBuffer, "%u %u %u",   &parseCmdData.teleCmd,
                                                 &parseCmdData.cmdPriority,
                                                 &parseCmdData.cmdData);
-                /* Add command data into Queue */
-                addNewCmdDataIntoQueue(&parseCmdData);
                 break;
                 
             case CMD_DELETE_CMD_FROM_QUEUE:
                 /* Parse the command values from buffer */
                 sscanf(cmdBuffer, "%u %u",  &parseCmdData.teleCmd,
                                             &parseCmdData.targetIdx);
-                /* Add command data into Queue */
-                addNewCmdDataIntoQueue(&parseCmdData);
                 break;
                 
             case CMD_MODIFY_CMD_DATA_IN_QUEUE:
@@ -115,271 +361,568 @@ VOID telecmdInterpreter(VOID)
                 sscanf(cmdBuffer, "%u %u %u",   &parseCmdData.teleCmd,
                                                 &parseCmdData.targetIdx,
                                                 &parseCmdData.newCmdData);
-                /* Add command data into Queue */
-                addNewCmdDataIntoQueue(&parseCmdData);
                 break;
             
-            case CMD_PRINT_CMDS:
-                /* Utility command: Print the command list */
-                printCmdDataQueue();
+            case CMD_EXECUTE_TOP_K_CMDS:
+            case CMD_PRINT_TOP_K_CMDS:
+                /* Parse number of commands, it is carried in cmdData */
+                sscanf(cmdBuffer, "%u %u",  &parseCmdData.teleCmd,
+                                            &parseCmdData.cmdData);
                 break;
                 
+            case CMD_PRINT_CMDS:
             case CMD_SORT_CMD_QUEUE:
-                /* Utility command: Sort the command list */
-                sortTeleCmdQueue();
-                break;
-
             case CMD_REVERSE_CMD_QUEUE:
-                /* Utility command: Reverse the command list */
-                reverseCmdQueue();
-                break;
-
             case CMD_EXECUTE_CMDS:
-                /* Utility command: Execute the command list */
-                executeCmdFromQueue();
+            case CMD_PARALLEL_EXECUTE_CMDS:
+                /* Utility command: No values to parse */
                 break;
                 
             default:
-                printf("ERROR: Invalid Command Received [%s]\n", cmdBuffer);
-                break;
+                fprintf(TELECMD_OUT, "ERROR: Invalid Command Received [%s]\n", cmdBuffer);
+                continue;
         }
+        
+        /* Queue or execute the parsed command */
+        processTeleCmd(&parseCmdData);
     }
     fclose(pCmdFile);
+    return TRUE;
 }
 
 /*------------------------------------------------------------------------------
- * FUNCTION: addNewCmdDataIntoQueue()
+ * FUNCTION: runShardTask()
  *------------------------------------------------------------------------------
- * ABSTRACT: This function will allocate memory in heap section for new data
- *           node, fill the data and it will add new data node into
- *           telecommand queue.
+ * ABSTRACT: This Function will process one batch file as Queue shard on the
+ *           current pool thread. Queue state is per thread, so shard starts
+ *           with empty Queue and entry Idx 0 and its output is collected in
+ *           memory until it can be reported. Leftover Queue is sorted and
+ *           kept for merge, or freed.
  *------------------------------------------------------------------------------
  * PARAMETERS:
- *              IN:    Address of new telecommand struct node.
- *              OUT:   None
+ *             IN:    Address of CMD_SHARD_t
+ *             OUT:   None
  * RETURN VALUE: -
  *------------------------------------------------------------------------------
- * GLOBALS: pHeadTeleCmdQ (Head pointer of Queue)
- *          nodeEntryIdx (Unique Idx for nodes)
+ * GLOBALS: nodeEntryIdx (Unique Idx for nodes)
+ *          pHeadTeleCmdQ (Head pointer of Queue)
+ *          pTeleCmdOutFile (Output of thread)
  *----------------------------------------------------------------------------*/
-static VOID addNewCmdDataIntoQueue(TELECMD_CONFIG_t *pRcvdTeleCmdData)
+static VOID runShardTask(VOIDPTR pTaskArg)
 {
-    /* Allocate heap memory for new command node */
-    TELE_CMD_LIST_t *pNewTeleCmdNode = (TELE_CMD_LIST_t *) malloc(sizeof(TELE_CMD_LIST_t));
+    CMD_SHARD_t *pShard = (CMD_SHARD_t *) pTaskArg;
+    struct timespec startTime; /* start of shard */
+    struct timespec endTime; /* end of shard */
     
-    if (pNewTeleCmdNode == NULL)
+    clock_gettime(CLOCK_MONOTONIC, &startTime);
+    
+    /* Fresh Queue and entry Idx space for the shard */
+    freeCmdQueue();
+    nodeEntryIdx = INVALID_VAL;
+    /* If memory stream fails, output goes to stdout unbuffered by shard */
+    pTeleCmdOutFile = open_memstream(&pShard->pOutput, &pShard->sizeOfOutput);
+    
+    pShard->isFileRead = interpretCmdFile(pShard->pFilePath, &pShard->numOfCmdLines);
+    pShard->numOfQueuedCmds = queueNodeCount - tombstoneCount;
+    
+    if (pShard->isMergeRequired == TRUE)
     {
-        printf("ERROR: Failed to assign dynamic memory for new node\n");
-        return;
+        /* Sort also drops the tombstones, then take the Queue over */
+        sortTeleCmdQueue();
+        pShard->pQueueHead = pHeadTeleCmdQ;
+        pHeadTeleCmdQ = NULL;
+        queueNodeCount = INVALID_VAL;
+        tombstoneCount = INVALID_VAL;
+    }
+    else
+    {
+        freeCmdQueue();
     }
     
-    /* Assign unique entry Idx to new node for further reference */
-    pRcvdTeleCmdData->entryIdx = nodeEntryIdx++;
-    /* Copy the parsed command data into heap memory of new node */
-    memcpy( &(pNewTeleCmdNode->teleCmdData), pRcvdTeleCmdData, sizeof(TELECMD_CONFIG_t) );
-
-    /* Update the pointers of new node */
-    pNewTeleCmdNode->pNextCmdNode = pHeadTeleCmdQ;
-    pNewTeleCmdNode->pPrevCmdNode = NULL;
-     
-    if (pHeadTeleCmdQ != NULL)
+    if (pTeleCmdOutFile != NULL)
     {
-        /* update the previous node pointer of first node if list not empty*/
-        pHeadTeleCmdQ->pPrevCmdNode = pNewTeleCmdNode;
+        fclose(pTeleCmdOutFile);
+        pTeleCmdOutFile = NULL;
     }
     
-    /* Update the head pointer as nodes are added at front of list */
-    pHeadTeleCmdQ = pNewTeleCmdNode;
-    return;
+    clock_gettime(CLOCK_MONOTONIC, &endTime);
+    pShard->elapsedUsec = ((UINT64) (endTime.tv_sec - startTime.tv_sec) * 1000000) +
+                          (UINT64) ((endTime.tv_nsec - startTime.tv_nsec) / 1000);
+    
+    reportFinishedShards(pShard);
 }
 
 /*------------------------------------------------------------------------------
- * FUNCTION: deleteCmdDataFromQueue()
+ * FUNCTION: reportFinishedShards()
  *------------------------------------------------------------------------------
- * ABSTRACT: This function will find node with given entry idx and delete that
- *           node from Queue.
+ * ABSTRACT: This Function will mark the shard as done and print every done
+ *           shard from first not reported one onwards, so output stays in
+ *           file order and is written as early as possible. Output buffer of
+ *           a reported shard is freed.
  *------------------------------------------------------------------------------
  * PARAMETERS:
- *              IN:    Entry Idx
- *              OUT:   None
+ *             IN:    Address of finished shard
+ *             OUT:   None
  * RETURN VALUE: -
  *------------------------------------------------------------------------------
- * GLOBALS: pHeadTeleCmdQ (Head pointer of Queue)
+ * GLOBALS: -
+ *
  *----------------------------------------------------------------------------*/
-static VOID deleteCmdDataFromQueue(UINT32 refEntryIdx)
+static VOID reportFinishedShards(CMD_SHARD_t *pShard)
 {
-    TELE_CMD_LIST_t  *pCurPosNode = pHeadTeleCmdQ; /* Ptr for Queue Handling */
+    CMD_SHARD_RUN_t *pShardRun = pShard->pShardRun; /* run of the shard */
     
-    while (pCurPosNode != NULL)
+    pthread_mutex_lock(&pShardRun->reportLock);
+    pShard->isDone = TRUE;
+    while ((pShardRun->nextReportIdx < pShardRun->numOfShards) &&
+           (pShardRun->pShards[pShardRun->nextReportIdx].isDone == TRUE))
     {
-        /* compare the entry Idx with target entry idx and delete the node */
-        if (pCurPosNode->teleCmdData.entryIdx == refEntryIdx)
+        CMD_SHARD_t *pReportShard = &pShardRun->pShards[pShardRun->nextReportIdx];
+        
+        fprintf(pShardRun->pReportFile, "==== [%u] %s: %u lines, %u commands left, %.3f ms ====\n",
+                pShardRun->nextReportIdx, pReportShard->pFilePath, pReportShard->numOfCmdLines,
+                pReportShard->numOfQueuedCmds, (double) pReportShard->elapsedUsec / 1000.0);
+        if (pReportShard->pOutput != NULL)
         {
-            if (pCurPosNode == pHeadTeleCmdQ)
-            {
-                pHeadTeleCmdQ = pCurPosNode->pNextCmdNode;
-            }
-            else
-            {
-                pCurPosNode->pPrevCmdNode->pNextCmdNode = pCurPosNode->pNextCmdNode;
-            }
-            /* Free the memory of node */
-            free(pCurPosNode);
-            return;
+            fwrite(pReportShard->pOutput, 1, pReportShard->sizeOfOutput, pShardRun->pReportFile);
         }
-        pCurPosNode = pCurPosNode->pNextCmdNode;
+        fflush(pShardRun->pReportFile);
+        pShardRun->numOfCmdLines += pReportShard->numOfCmdLines;
+        if (pReportShard->isFileRead == FALSE)
+        {
+            pShardRun->numOfFailedFiles++;
+        }
+        free(pReportShard->pOutput);
+        pReportShard->pOutput = NULL;
+        pShardRun->nextReportIdx++;
     }
-    
-    printf("ERROR: deleteCmdDataFromQueue: Node not found in Queue\n");
-    return;
+    pthread_mutex_unlock(&pShardRun->reportLock);
 }
 
 /*------------------------------------------------------------------------------
- * FUNCTION: sortTeleCmdQueue()
+ * FUNCTION: printMergedShardQueues()
  *------------------------------------------------------------------------------
- * ABSTRACT: This function will Ensure that commands are sorted by their
- *           priorities. For sorting we are using merge sort because
- *           it is very efficient for immutable datastructures.
+ * ABSTRACT: This Function will merge the sorted leftover Queues of all the
+ *           shards by priority (k way merge with heap of shard heads) and
+ *           print each command with index of its shard. On same priority
+ *           the shard given first comes first. Nodes are freed after print.
  *------------------------------------------------------------------------------
  * PARAMETERS:
- *              IN:    None
- *              OUT:   None
+ *             IN:    Shards, number of shards
+ *             OUT:   None
  * RETURN VALUE: -
  *------------------------------------------------------------------------------
- * GLOBALS: pHeadTeleCmdQ (Head pointer of Queue),
- *          pFirstHandlerPtr (Handling pointer for first part of queue),
- *          pFirstEndPtr (Handling pointer for first part of queue),
- *          pSecondHandlerPtr (Handling pointer for second part of queue),
- *          pSecondEndPtr(Handling pointer for second part of queue)
+ * GLOBALS: -
+ *
  *----------------------------------------------------------------------------*/
-static VOID sortTeleCmdQueue(VOID)
+static VOID printMergedShardQueues(CMD_SHARD_t *pShards, UINT32 numOfShards)
 {
-    /* If list is empty, no need to sort */
-    if (pHeadTeleCmdQ == NULL)
+    TOP_K_ENTRY_t *pShardHeap = (TOP_K_ENTRY_t *) malloc(numOfShards * sizeof(TOP_K_ENTRY_t));
+    UINT32 heapSize = INVALID_VAL; /* shards with commands left */
+    UINT32 numOfCmds = INVALID_VAL; /* commands of all shards */
+    UINT32 shardIdx = INVALID_VAL; /* loop var for shards */
+    
+    if (pShardHeap == NULL)
     {
+        fprintf(TELECMD_OUT, "ERROR: Failed to assign dynamic memory for shard merge\n");
         return;
     }
     
-    TELE_CMD_LIST_t *pHoldNode = NULL; /* hold location to handle pointers */
-    UINT32 lHalfQueueVar = INVALID_VAL;  /* loop varible for devide the list */
-    UINT32 lenOfQueue = getLengthOfCmdQueue(); /* length of the list */
+    /* Queue position of heap entry holds the shard index */
+    for (shardIdx = 0; shardIdx < numOfShards; shardIdx++)
+    {
+        numOfCmds += pShards[shardIdx].numOfQueuedCmds;
+        if (pShards[shardIdx].pQueueHead != NULL)
+        {
+            pShardHeap[heapSize].pCmdNode = pShards[shardIdx].pQueueHead;
+            pShardHeap[heapSize].queuePos = shardIdx;
+            heapSize++;
+        }
+    }
+    for (shardIdx = heapSize / 2; shardIdx > 0; shardIdx--)
+    {
+        siftDownShardHeap(pShardHeap, heapSize, shardIdx - 1);
+    }
     
-    /* The loop var is initially 1. It is incremented as 2, 4, 8, ..
-       until it reaches the length of the linked list. For each loop,
-       the linked list is sorted around the loop */
-    for (lHalfQueueVar = 1; lHalfQueueVar < lenOfQueue; lHalfQueueVar = lHalfQueueVar*2)
+    fprintf(TELECMD_OUT, "==== Merged queue: %u commands ====\n", numOfCmds);
+    while (heapSize > 0)
     {
-        /* Everytime start first list pointer from head location */
-        pFirstHandlerPtr = pHeadTeleCmdQ;
-        while (pFirstHandlerPtr)
+        TELE_CMD_LIST_t *pCmdNode = pShardHeap[0].pCmdNode; /* most urgent */
+        
+        fprintf(TELECMD_OUT, "[%u] ", pShardHeap[0].queuePos);
+        printCmdNode(pCmdNode);
+        
+        /* Continue with next node of same shard or drop the shard */
+        if (pCmdNode->pNextCmdNode != NULL)
         {
-            UINT32 lHalfQCounter = lHalfQueueVar; /* counter for end pointer handling */
-            BOOL isFirstIter = FALSE; /* flag var to check first iteration */
-            TELE_CMD_LIST_t *pNextIterNode  = NULL; /* Pointer to store next iteration start location */
-            
-            /* If it is first iteration, update the flag value */
-            if (pFirstHandlerPtr == pHeadTeleCmdQ)
-            {
-                isFirstIter = TRUE;
-            }
-
-            pFirstEndPtr = pFirstHandlerPtr;
-            /* Set first end pointer as per loop cont and end of list */
-            while (--lHalfQCounter && pFirstEndPtr->pNextCmdNode)
-            {
-                pFirstEndPtr = pFirstEndPtr->pNextCmdNode;
-            }
-            
-            /* set second list pointer as per end of first list */
-            pSecondHandlerPtr = pFirstEndPtr->pNextCmdNode;
-            if (pSecondHandlerPtr == NULL)
-            {
-                /* end of list, so break the loop */
-                break;
-            }
-            
-            /* Reupdate the counter for second end pointer */
-            lHalfQCounter = lHalfQueueVar;
-            
-            pSecondEndPtr = pSecondHandlerPtr;
-            /* Set second end pointer as per loop cont and end of list */
-            while (--lHalfQCounter && pSecondEndPtr->pNextCmdNode)
-            {
-                pSecondEndPtr = pSecondEndPtr->pNextCmdNode;
-            }
-
-            /* store next iteartion location */
-            pNextIterNode = pSecondEndPtr->pNextCmdNode;
-            
-            /* merge and sort the list */
-            mergeReorderNodeOfQueue();
- 
-            if (isFirstIter == TRUE)
-            {
-                /* update head if iteration is first */
-                pHeadTeleCmdQ = pFirstHandlerPtr;
-            }
-            else
-            {
-                pHoldNode->pNextCmdNode = pFirstHandlerPtr;
-            }
-            
-            /* hold the second end pointer location and set first pointer */
-            pHoldNode = pSecondEndPtr;
-            pFirstHandlerPtr = pNextIterNode;
+            pShardHeap[0].pCmdNode = pCmdNode->pNextCmdNode;
         }
-        pHoldNode->pNextCmdNode = pFirstHandlerPtr;
+        else
+        {
+            pShardHeap[0] = pShardHeap[--heapSize];
+        }
+        siftDownShardHeap(pShardHeap, heapSize, 0);
+        free(pCmdNode);
     }
-    /* After sorting set NULL to first element of list */
-    pHeadTeleCmdQ->pPrevCmdNode = NULL;
+    
+    for (shardIdx = 0; shardIdx < numOfShards; shardIdx++)
+    {
+        pShards[shardIdx].pQueueHead = NULL;
+    }
+    free(pShardHeap);
 }
 
 /*------------------------------------------------------------------------------
- * FUNCTION: getLengthOfCmdQueue()
+ * FUNCTION: siftDownShardHeap()
  *------------------------------------------------------------------------------
- * ABSTRACT: This function will calculate the length of queue and return
- *           the length.
+ * ABSTRACT: This function will move heap entry down until both children are
+ *           less urgent, so most urgent shard head stays at root.
  *------------------------------------------------------------------------------
  * PARAMETERS:
- *              IN:    None
+ *              IN:    Heap, size of heap and index of entry to move
  *              OUT:   None
- * RETURN VALUE: Length of the Queue (UINT32)
  *------------------------------------------------------------------------------
- * GLOBALS: pHeadTeleCmdQ (Head pointer of Queue)
+ * GLOBALS: -
+ *
  *----------------------------------------------------------------------------*/
-static UINT32 getLengthOfCmdQueue(VOID)
+static VOID siftDownShardHeap(TOP_K_ENTRY_t *pShardHeap, UINT32 heapSize, UINT32 heapIdx)
 {
-    TELE_CMD_LIST_t* pCurPosNode = pHeadTeleCmdQ; /* Ptr for Queue Handling */
-    UINT32 countLen = INVALID_VAL; /* to count the length of list */
+    TOP_K_ENTRY_t holdEntry; /* entry to move down */
     
-    while(pCurPosNode != NULL)
+    if (heapIdx >= heapSize)
     {
-        countLen++;
-        pCurPosNode = pCurPosNode->pNextCmdNode;
+        return;
     }
     
-    return countLen;
-}
-
-/*------------------------------------------------------------------------------
- * FUNCTION: mergeReorderNodeOfQueue()
- *------------------------------------------------------------------------------
- * ABSTRACT: This function is used for sorting of Queue. It will check the
- *           command priority and sort it.
- *           It will compare the next value of pFirstHandlerPtr and
- *           current value of pSecondHandlerPtr and insert pSecondHandlerPtr
- *           after pFirstHandlerPtr if it's smaller than next value of
- *           pFirstHandlerPtr. do this until pFirstHandlerPtr or
- *           pSecondHandlerPtr end.
- *           If pFirstHandlerPtr ends, then we assign next of pFirstHandlerPtr
- *           to pSecondHandlerPtr because pSecondHandlerPtr may have some
- *           elements left out which are greater than the last value of
- *           pFirstHandlerPtr. If pSecondHandlerPtr ends then it will assign
- *           pSecondEndPtr to pFirstEndPtr.
+    holdEntry = pShardHeap[heapIdx];
+    while (TRUE)
+    {
+        UINT32 childIdx = (2 * heapIdx) + 1; /* left child */
+        
+        if (childIdx >= heapSize)
+        {
+            break;
+        }
+        /* Take the more urgent child */
+        if (((childIdx + 1) < heapSize) &&
+            (isLessUrgentEntry(&pShardHeap[childIdx], &pShardHeap[childIdx + 1]) == TRUE))
+        {
+            childIdx++;
+        }
+        if (isLessUrgentEntry(&holdEntry, &pShardHeap[childIdx]) == FALSE)
+        {
+            break;
+        }
+        pShardHeap[heapIdx] = pShardHeap[childIdx];
+        heapIdx = childIdx;
+    }
+    pShardHeap[heapIdx] = holdEntry;
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: freeCmdQueue()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will free all the nodes of the Queue, tombstones
+ *           included, and leave an empty Queue.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    None
+ *              OUT:   None
+ *------------------------------------------------------------------------------
+ * GLOBALS: pHeadTeleCmdQ (Head pointer of Queue)
+ *          queueNodeCount (Number of nodes in Queue)
+ *          tombstoneCount (Number of deleted nodes pending for compaction)
+ *----------------------------------------------------------------------------*/
+static VOID freeCmdQueue(VOID)
+{
+    while (pHeadTeleCmdQ != NULL)
+    {
+        TELE_CMD_LIST_t *pNextNode = pHeadTeleCmdQ->pNextCmdNode; /* next node */
+        
+        free(pHeadTeleCmdQ);
+        pHeadTeleCmdQ = pNextNode;
+    }
+    queueNodeCount = INVALID_VAL;
+    tombstoneCount = INVALID_VAL;
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: telecmdInterpreterShmRing()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This Function will attach to the shared memory ring filled by
+ *           ground station front end and process the telecommand records
+ *           batch by batch, until producer closes the ring or dies.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *             IN:    Name of shared memory ring
+ *             OUT:   None
+ * RETURN VALUE: TRUE if producer closed the ring, FALSE if ring could not
+ *               be attached or producer died
+ *------------------------------------------------------------------------------
+ * GLOBALS: -
+ *
+ *----------------------------------------------------------------------------*/
+BOOL telecmdInterpreterShmRing(const CHAR *pRingName)
+{
+    TELECMD_SHM_RING_t *pRing = attachCmdShmRing(pRingName); /* cmd ring */
+    struct timespec pollSleep = {0, SHM_POLL_MIN_SLEEP_NSEC}; /* backoff */
+    UINT32 numOfEmptyPolls = INVALID_VAL; /* polls since last record */
+    BOOL isProducerGone = FALSE; /* producer died before last poll */
+    
+    if (pRing == NULL)
+    {
+        fprintf(TELECMD_OUT, "ERROR: Failed to attach telecommand ring\n");
+        return FALSE;
+    }
+    
+    while (TRUE)
+    {
+        TELECMD_CONFIG_t *pCmdRecords = NULL; /* first acquired record */
+        UINT32 numOfRecords = telecmdShmRingAcquire(pRing, &pCmdRecords);
+        UINT32 recordIdx = INVALID_VAL; /* loop var for acquired records */
+        
+        if (numOfRecords == INVALID_VAL)
+        {
+            /* Ring is empty, stop if producer is done otherwise wait */
+            if (telecmdShmRingIsDrained(pRing) == TRUE)
+            {
+                break;
+            }
+            /* Producer was gone already before this poll, nothing more comes */
+            if (isProducerGone == TRUE)
+            {
+                fprintf(TELECMD_OUT, "ERROR: Telecommand ring producer died without closing the ring\n");
+                telecmdShmRingDetach(pRing);
+                return FALSE;
+            }
+            
+            if (numOfEmptyPolls < SHM_POLL_SPIN_COUNT)
+            {
+                numOfEmptyPolls++;
+                sched_yield();
+            }
+            else
+            {
+                isProducerGone = (telecmdShmRingIsProducerAlive(pRing) == TRUE) ? FALSE : TRUE;
+                nanosleep(&pollSleep, NULL);
+                pollSleep.tv_nsec *= 2;
+                if (pollSleep.tv_nsec > SHM_POLL_MAX_SLEEP_NSEC)
+                {
+                    pollSleep.tv_nsec = SHM_POLL_MAX_SLEEP_NSEC;
+                }
+            }
+            continue;
+        }
+        numOfEmptyPolls = INVALID_VAL;
+        pollSleep.tv_nsec = SHM_POLL_MIN_SLEEP_NSEC;
+        
+        for (recordIdx = 0; recordIdx < numOfRecords; recordIdx++)
+        {
+            /* Work on a copy, the slot belongs to producer's memory */
+            TELECMD_CONFIG_t rcvdCmdData = pCmdRecords[recordIdx];
+            
+            processTeleCmd(&rcvdCmdData);
+        }
+        
+        /* Give whole batch back to producer at once */
+        telecmdShmRingRelease(pRing, numOfRecords);
+    }
+    
+    telecmdShmRingDetach(pRing);
+    return TRUE;
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: attachCmdShmRing()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This Function will attach to the shared memory ring, retrying
+ *           while producer has not created or initialised it yet, for at
+ *           most SHM_ATTACH_TIMEOUT_MSEC. So consumer may start first.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *             IN:    Name of shared memory ring
+ *             OUT:   None
+ * RETURN VALUE: Mapped ring, NULL on failure or timeout
+ *------------------------------------------------------------------------------
+ * GLOBALS: -
+ *
+ *----------------------------------------------------------------------------*/
+static TELECMD_SHM_RING_t *attachCmdShmRing(const CHAR *pRingName)
+{
+    struct timespec retrySleep = {0, SHM_POLL_MAX_SLEEP_NSEC}; /* retry gap */
+    UINT32 numOfRetries = INVALID_VAL; /* attempts so far */
+    TELECMD_SHM_RING_t *pRing = telecmdShmRingOpen(pRingName); /* cmd ring */
+    
+    while ((pRing == NULL) && ((errno == ENOENT) || (errno == EAGAIN)) &&
+           (numOfRetries < (SHM_ATTACH_TIMEOUT_MSEC * 1000000ULL) / SHM_POLL_MAX_SLEEP_NSEC))
+    {
+        nanosleep(&retrySleep, NULL);
+        numOfRetries++;
+        pRing = telecmdShmRingOpen(pRingName);
+    }
+    return pRing;
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: processTeleCmd()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This Function will check the command type of received command
+ *           and based on type it will execute it or add into queue.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *             IN:    Address of received telecommand data
+ *             OUT:   None
+ * RETURN VALUE: -
+ *------------------------------------------------------------------------------
+ * GLOBALS: -
+ *
+ *----------------------------------------------------------------------------*/
+static VOID processTeleCmd(TELECMD_CONFIG_t *pRcvdTeleCmdData)
+{
+    switch(pRcvdTeleCmdData->teleCmd)
+    {
+        case CMD_NEWCMD_WITH_LOW_PRIO:
+        case CMD_NEWCMD_WITH_USER_PRIO:
+        case CMD_DELETE_CMD_FROM_QUEUE:
+        case CMD_MODIFY_CMD_DATA_IN_QUEUE:
+            /* Add command data into Queue */
+            addNewCmdDataIntoQueue(pRcvdTeleCmdData);
+            break;
+        
+        case CMD_PRINT_CMDS:
+            /* Utility command: Print the command list */
+            printCmdDataQueue();
+            break;
+            
+        case CMD_SORT_CMD_QUEUE:
+            /* Utility command: Sort the command list */
+            sortTeleCmdQueue();
+            break;
+
+        case CMD_REVERSE_CMD_QUEUE:
+            /* Utility command: Reverse the command list */
+            reverseCmdQueue();
+            break;
+
+        case CMD_EXECUTE_CMDS:
+            /* Utility command: Execute the command list */
+            executeCmdFromQueue();
+            break;
+            
+        case CMD_EXECUTE_TOP_K_CMDS:
+            /* Utility command: Execute the K most urgent commands */
+            executeTopKCmdsFromQueue(pRcvdTeleCmdData->cmdData);
+            break;
+            
+        case CMD_PRINT_TOP_K_CMDS:
+            /* Utility command: Print the K most urgent commands */
+            printTopKCmdsFromQueue(pRcvdTeleCmdData->cmdData);
+            break;
+            
+        case CMD_PARALLEL_EXECUTE_CMDS:
+            /* Utility command: Execute the command list on all cores */
+            executeCmdQueueParallel();
+            break;
+            
+        default:
+            fprintf(TELECMD_OUT, "ERROR: Invalid Command Received [%u]\n", pRcvdTeleCmdData->teleCmd);
+            break;
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: addNewCmdDataIntoQueue()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will allocate memory in heap section for new data
+ *           node, fill the data and it will add new data node into
+ *           telecommand queue.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    Address of new telecommand struct node.
+ *              OUT:   None
+ * RETURN VALUE: -
+ *------------------------------------------------------------------------------
+ * GLOBALS: pHeadTeleCmdQ (Head pointer of Queue)
+ *          nodeEntryIdx (Unique Idx for nodes)
+ *----------------------------------------------------------------------------*/
+static VOID addNewCmdDataIntoQueue(TELECMD_CONFIG_t *pRcvdTeleCmdData)
+{
+    /* Allocate heap memory for new command node */
+    TELE_CMD_LIST_t *pNewTeleCmdNode = (TELE_CMD_LIST_t *) malloc(sizeof(TELE_CMD_LIST_t));
+    
+    if (pNewTeleCmdNode == NULL)
+    {
+        fprintf(TELECMD_OUT, "ERROR: Failed to assign dynamic memory for new node\n");
+        return;
+    }
+    
+    /* Assign unique entry Idx to new node for further reference */
+    pRcvdTeleCmdData->entryIdx = nodeEntryIdx++;
+    /* Copy the parsed command data into heap memory of new node */
+    memcpy( &(pNewTeleCmdNode->teleCmdData), pRcvdTeleCmdData, sizeof(TELECMD_CONFIG_t) );
+
+    /* Update the pointers of new node */
+    pNewTeleCmdNode->pNextCmdNode = pHeadTeleCmdQ;
+    pNewTeleCmdNode->pPrevCmdNode = NULL;
+    pNewTeleCmdNode->isTombstone = FALSE;
+     
+    if (pHeadTeleCmdQ != NULL)
+    {
+        /* update the previous node pointer of first node if list not empty*/
+        pHeadTeleCmdQ->pPrevCmdNode = pNewTeleCmdNode;
+    }
+    
+    /* Update the head pointer as nodes are added at front of list */
+    pHeadTeleCmdQ = pNewTeleCmdNode;
+    queueNodeCount++;
+    return;
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: deleteCmdDataFromQueue()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will find node with given entry idx and delete that
+ *           node from Queue.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    Entry Idx
+ *              OUT:   None
+ * RETURN VALUE: -
+ *------------------------------------------------------------------------------
+ * GLOBALS: pHeadTeleCmdQ (Head pointer of Queue)
+ *----------------------------------------------------------------------------*/
+static VOID deleteCmdDataFromQueue(UINT32 refEntryIdx)
+{
+    TELE_CMD_LIST_t  *pCurPosNode = pHeadTeleCmdQ; /* Ptr for Queue Handling */
+    
+    while (pCurPosNode != NULL)
+    {
+        /* compare the entry Idx with target entry idx and delete the node */
+        if ((pCurPosNode->isTombstone == FALSE) &&
+            (pCurPosNode->teleCmdData.entryIdx == refEntryIdx))
+        {
+            removeNodeFromQueue(pCurPosNode);
+            return;
+        }
+        pCurPosNode = pCurPosNode->pNextCmdNode;
+    }
+    
+    fprintf(TELECMD_OUT, "ERROR: deleteCmdDataFromQueue: Node not found in Queue\n");
+    return;
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: sortTeleCmdQueue()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will Ensure that commands are sorted by their
+ *           priorities. For sorting we are using merge sort because
+ *           it is very efficient for immutable datastructures. Sort is
+ *           stable, commands of same priority keep their Queue order.
  *------------------------------------------------------------------------------
  * PARAMETERS:
  *              IN:    None
  *              OUT:   None
+ * RETURN VALUE: -
  *------------------------------------------------------------------------------
  * GLOBALS: pHeadTeleCmdQ (Head pointer of Queue),
  *          pFirstHandlerPtr (Handling pointer for first part of queue),
@@ -387,228 +930,1246 @@ static UINT32 getLengthOfCmdQueue(VOID)
  *          pSecondHandlerPtr (Handling pointer for second part of queue),
  *          pSecondEndPtr(Handling pointer for second part of queue)
  *----------------------------------------------------------------------------*/
-static VOID mergeReorderNodeOfQueue(VOID)
+static VOID sortTeleCmdQueue(VOID)
 {
-    TELE_CMD_LIST_t *pMergeA    = NULL; /* Merge pointer for List A */
-    TELE_CMD_LIST_t *pMergeB    = NULL; /* Merge pointer for List B */
-    TELE_CMD_LIST_t *pMergeEndA = NULL; /* Merge end pointer for List A */
-    TELE_CMD_LIST_t *pMergeEndB = NULL; /* Merge end pointer for List A */
-
-    /* if priority of first list pointer is less then second list pointer,
-    Swap the pointers of first and second list */
-    if (pFirstHandlerPtr->teleCmdData.cmdPriority < pSecondHandlerPtr->teleCmdData.cmdPriority)
+    /* If list is empty, no need to sort */
+    if (pHeadTeleCmdQ == NULL)
     {
-        swapHandlingPtr();
+        return;
+    }
+    
+    /* Drop pending tombstones so they are not moved around by the sort */
+    if (tombstoneCount != INVALID_VAL)
+    {
+        compactCmdQueue();
+        if (pHeadTeleCmdQ == NULL)
+        {
+            return;
+        }
+    }
+    
+    TELE_CMD_LIST_t *pHoldNode = NULL; /* hold location to handle pointers */
+    UINT32 lHalfQueueVar = INVALID_VAL;  /* loop varible for devide the list */
+    UINT32 lenOfQueue = getLengthOfCmdQueue(); /* length of the list */
+    UINT32 numOfWorkers = telecmdPoolGetNumOfWorkers(); /* worker threads */
+    
+    /* Array sort gives same order for any number of workers, large Queue
+     * is sorted on all cores */
+    if (lenOfQueue < PARALLEL_SORT_MIN_CMDS)
+    {
+        numOfWorkers = 1;
+    }
+    if (sortTeleCmdQueueParallel(lenOfQueue, numOfWorkers) == TRUE)
+    {
+        return;
+    }
+    
+    /* Not enough memory for the arrays, sort the list in place */
+    /* The loop var is initially 1. It is incremented as 2, 4, 8, ..
+       until it reaches the length of the linked list. For each loop,
+       the linked list is sorted around the loop */
+    for (lHalfQueueVar = 1; lHalfQueueVar < lenOfQueue; lHalfQueueVar = lHalfQueueVar*2)
+    {
+        /* Everytime start first list pointer from head location */
+        pFirstHandlerPtr = pHeadTeleCmdQ;
+        while (pFirstHandlerPtr)
+        {
+            UINT32 lHalfQCounter = lHalfQueueVar; /* counter for end pointer handling */
+            BOOL isFirstIter = FALSE; /* flag var to check first iteration */
+            TELE_CMD_LIST_t *pNextIterNode  = NULL; /* Pointer to store next iteration start location */
+            
+            /* If it is first iteration, update the flag value */
+            if (pFirstHandlerPtr == pHeadTeleCmdQ)
+            {
+                isFirstIter = TRUE;
+            }
+
+            pFirstEndPtr = pFirstHandlerPtr;
+            /* Set first end pointer as per loop cont and end of list */
+            while (--lHalfQCounter && pFirstEndPtr->pNextCmdNode)
+            {
+                pFirstEndPtr = pFirstEndPtr->pNextCmdNode;
+            }
+            
+            /* set second list pointer as per end of first list */
+            pSecondHandlerPtr = pFirstEndPtr->pNextCmdNode;
+            if (pSecondHandlerPtr == NULL)
+            {
+                /* end of list, so break the loop */
+                break;
+            }
+            
+            /* Reupdate the counter for second end pointer */
+            lHalfQCounter = lHalfQueueVar;
+            
+            pSecondEndPtr = pSecondHandlerPtr;
+            /* Set second end pointer as per loop cont and end of list */
+            while (--lHalfQCounter && pSecondEndPtr->pNextCmdNode)
+            {
+                pSecondEndPtr = pSecondEndPtr->pNextCmdNode;
+            }
+
+            /* store next iteartion location */
+            pNextIterNode = pSecondEndPtr->pNextCmdNode;
+            
+            /* merge and sort the list */
+            mergeReorderNodeOfQueue();
+ 
+            if (isFirstIter == TRUE)
+            {
+                /* update head if iteration is first */
+                pHeadTeleCmdQ = pFirstHandlerPtr;
+            }
+            else
+            {
+                pHoldNode->pNextCmdNode = pFirstHandlerPtr;
+            }
+            
+            /* hold the second end pointer location and set first pointer */
+            pHoldNode = pSecondEndPtr;
+            pFirstHandlerPtr = pNextIterNode;
+        }
+        pHoldNode->pNextCmdNode = pFirstHandlerPtr;
+    }
+    /* After sorting set NULL to first element of list and repair the
+     * back links, merge keeps only the forward links right */
+    pHeadTeleCmdQ->pPrevCmdNode = NULL;
+    for (pHoldNode = pHeadTeleCmdQ; pHoldNode->pNextCmdNode != NULL; pHoldNode = pHoldNode->pNextCmdNode)
+    {
+        pHoldNode->pNextCmdNode->pPrevCmdNode = pHoldNode;
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: getLengthOfCmdQueue()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will calculate the length of queue and return
+ *           the length.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    None
+ *              OUT:   None
+ * RETURN VALUE: Length of the Queue (UINT32)
+ *------------------------------------------------------------------------------
+ * GLOBALS: pHeadTeleCmdQ (Head pointer of Queue)
+ *----------------------------------------------------------------------------*/
+static UINT32 getLengthOfCmdQueue(VOID)
+{
+    TELE_CMD_LIST_t* pCurPosNode = pHeadTeleCmdQ; /* Ptr for Queue Handling */
+    UINT32 countLen = INVALID_VAL; /* to count the length of list */
+    
+    while(pCurPosNode != NULL)
+    {
+        countLen++;
+        pCurPosNode = pCurPosNode->pNextCmdNode;
+    }
+    
+    return countLen;
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: mergeReorderNodeOfQueue()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function is used for sorting of Queue. It will check the
+ *           command priority and sort it.
+ *           It will compare the next value of pFirstHandlerPtr and
+ *           current value of pSecondHandlerPtr and insert pSecondHandlerPtr
+ *           after pFirstHandlerPtr if it's smaller than next value of
+ *           pFirstHandlerPtr. do this until pFirstHandlerPtr or
+ *           pSecondHandlerPtr end.
+ *           If pFirstHandlerPtr ends, then we assign next of pFirstHandlerPtr
+ *           to pSecondHandlerPtr because pSecondHandlerPtr may have some
+ *           elements left out which are greater than the last value of
+ *           pFirstHandlerPtr. If pSecondHandlerPtr ends then it will assign
+ *           pSecondEndPtr to pFirstEndPtr.
+ *           On same priority node of the earlier list goes first, so the
+ *           merge is stable also when the lists were swapped.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    None
+ *              OUT:   None
+ *------------------------------------------------------------------------------
+ * GLOBALS: pHeadTeleCmdQ (Head pointer of Queue),
+ *          pFirstHandlerPtr (Handling pointer for first part of queue),
+ *          pFirstEndPtr (Handling pointer for first part of queue),
+ *          pSecondHandlerPtr (Handling pointer for second part of queue),
+ *          pSecondEndPtr(Handling pointer for second part of queue)
+ *----------------------------------------------------------------------------*/
+static VOID mergeReorderNodeOfQueue(VOID)
+{
+    TELE_CMD_LIST_t *pMergeA    = NULL; /* Merge pointer for List A */
+    TELE_CMD_LIST_t *pMergeB    = NULL; /* Merge pointer for List B */
+    TELE_CMD_LIST_t *pMergeEndA = NULL; /* Merge end pointer for List A */
+    TELE_CMD_LIST_t *pMergeEndB = NULL; /* Merge end pointer for List A */
+    BOOL isSwapped = FALSE; /* List B is the earlier list in Queue */
+
+    /* if priority of first list pointer is less then second list pointer,
+    Swap the pointers of first and second list */
+    if (pFirstHandlerPtr->teleCmdData.cmdPriority < pSecondHandlerPtr->teleCmdData.cmdPriority)
+    {
+        swapHandlingPtr();
+        isSwapped = TRUE;
+    }
+ 
+    /* store first second handling pointers into merge pointers */
+    pMergeA     = pFirstHandlerPtr;
+    pMergeB     = pSecondHandlerPtr;
+    pMergeEndA  = pFirstEndPtr;
+    pMergeEndB  = pSecondEndPtr->pNextCmdNode;
+ 
+    /* Check Merge pointer location for first list and second list */
+    while (pMergeA != pMergeEndA && pMergeB != pMergeEndB)
+    {
+        UINT32 nextPrioA = pMergeA->pNextCmdNode->teleCmdData.cmdPriority;
+        
+        /* swap the node if priority of first list node is less than second,
+         * on same priority only if second list is the earlier one */
+        if ((nextPrioA < pMergeB->teleCmdData.cmdPriority) ||
+            ((isSwapped == TRUE) && (nextPrioA == pMergeB->teleCmdData.cmdPriority)))
+        {
+            TELE_CMD_LIST_t *pSwapNode = pMergeB->pNextCmdNode;
+            pMergeB->pNextCmdNode = pMergeA->pNextCmdNode;
+            pMergeA->pNextCmdNode = pMergeB;
+            pMergeB->pPrevCmdNode = pMergeA;
+            pMergeB->pNextCmdNode->pPrevCmdNode = pMergeB;
+            pMergeB = pSwapNode;
+        }
+        pMergeA = pMergeA->pNextCmdNode;
+    }
+    
+
+    if (pMergeA == pMergeEndA)
+    {
+        /* assign next of pFirstHandlerPtr to pSecondHandlerPtr because
+         * pSecondHandlerPtr may have some elements left out which are greater
+         * than the last value of pFirstHandlerPtr */
+        pMergeA->pNextCmdNode = pMergeB;
+        pMergeB->pPrevCmdNode = pMergeA;
+    }
+    else
+    {
+        pSecondEndPtr = pFirstEndPtr;
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: swapHandlingPtr()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function is used to swap pointers of first queue and
+ *           pointers of second queue.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    None
+ *              OUT:   None
+ *------------------------------------------------------------------------------
+ * GLOBALS:
+ *          pFirstHandlerPtr (Handling pointer for first part of queue),
+ *          pFirstEndPtr (Handling pointer for first part of queue),
+ *          pSecondHandlerPtr (Handling pointer for second part of queue),
+ *          pSecondEndPtr(Handling pointer for second part of queue)
+ *----------------------------------------------------------------------------*/
+static VOID swapHandlingPtr(VOID)
+{
+    TELE_CMD_LIST_t *pSwapNodePtr = NULL; /* temp pointer for swapping */
+    
+    /* Swap handler pointers*/
+    pSwapNodePtr = pFirstHandlerPtr;
+    pFirstHandlerPtr = pSecondHandlerPtr;
+    pSecondHandlerPtr = pSwapNodePtr;
+    /* Swap end pointers*/
+    pSwapNodePtr = pFirstEndPtr;
+    pFirstEndPtr = pSecondEndPtr;
+    pSecondEndPtr = pSwapNodePtr;
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: modifyCmdDataInQueue()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will find anf modify the command data using entry idx
+ *           of the node.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    Entry Idx and New Data
+ *              OUT:   None
+ *------------------------------------------------------------------------------
+ * GLOBALS: pHeadTeleCmdQ (Head pointer of Queue)
+ *----------------------------------------------------------------------------*/
+static VOID modifyCmdDataInQueue(UINT32 refEntryIdx, UINT32 refNewData)
+{
+    TELE_CMD_LIST_t *pCurPosNode = pHeadTeleCmdQ; /* Ptr for Queue Handling */
+    while(pCurPosNode != NULL)
+    {
+        /* Search for entry Idx and update the new data in to command node */
+        if((pCurPosNode->isTombstone == FALSE) &&
+           (pCurPosNode->teleCmdData.entryIdx == refEntryIdx))
+        {
+            pCurPosNode->teleCmdData.cmdData = refNewData;
+            return;
+        }
+        pCurPosNode = pCurPosNode->pNextCmdNode;
+    }
+    return;
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION:   printCmdDataQueue()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function is used to print the commands from queue based on
+ *           command id.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    None
+ *              OUT:   None
+ *------------------------------------------------------------------------------
+ * GLOBALS: pHeadTeleCmdQ (Head pointer of Queue)
+ *
+ *----------------------------------------------------------------------------*/
+static VOID printCmdDataQueue(VOID)
+{
+    TELE_CMD_LIST_t  *pCurPosNode = pHeadTeleCmdQ; /* Ptr for Queue Handling */
+    
+    while (pCurPosNode != NULL)
+    {
+        /* Deleted nodes are not part of the Queue anymore */
+        if (pCurPosNode->isTombstone == TRUE)
+        {
+            pCurPosNode = pCurPosNode->pNextCmdNode;
+            continue;
+        }
+        
+        printCmdNode(pCurPosNode);
+        pCurPosNode = pCurPosNode->pNextCmdNode;
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: printCmdNode()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function is used to print one command node based on
+ *           command id.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    Address of command node
+ *              OUT:   None
+ *------------------------------------------------------------------------------
+ * GLOBALS: -
+ *
+ *----------------------------------------------------------------------------*/
+static VOID printCmdNode(const TELE_CMD_LIST_t *pCmdNode)
+{
+    switch(pCmdNode->teleCmdData.teleCmd)
+    {
+        case CMD_NEWCMD_WITH_LOW_PRIO:
+            /* Print entry Idx, priority and data of the node */
+            fprintf(TELECMD_OUT, "(%u, %u, %u)\n", pCmdNode->teleCmdData.entryIdx,
+                                     pCmdNode->teleCmdData.cmdPriority,
+                                     pCmdNode->teleCmdData.cmdData);
+            break;
+            
+        case CMD_NEWCMD_WITH_USER_PRIO:
+            /* Print entry Idx, priority and data of the node */
+            fprintf(TELECMD_OUT, "(%u, %u, %u)\n", pCmdNode->teleCmdData.entryIdx,
+                                     pCmdNode->teleCmdData.cmdPriority,
+                                     pCmdNode->teleCmdData.cmdData);
+            break;
+            
+        case CMD_DELETE_CMD_FROM_QUEUE:
+            /* Print entry Idx and Target Idx which we want to detele */
+            fprintf(TELECMD_OUT, "(%u, %u)\n", pCmdNode->teleCmdData.entryIdx,
+                                 pCmdNode->teleCmdData.targetIdx);
+            break;
+            
+        case CMD_MODIFY_CMD_DATA_IN_QUEUE:
+            /* Print entry Idx, Target Idx and new data */
+            fprintf(TELECMD_OUT, "(%u, %u, %u)\n", pCmdNode->teleCmdData.entryIdx,
+                                     pCmdNode->teleCmdData.targetIdx,
+                                     pCmdNode->teleCmdData.newCmdData);
+            break;
+            
+        case CMD_SORT_CMD_QUEUE:
+        case CMD_PRINT_CMDS:
+        case CMD_REVERSE_CMD_QUEUE:
+        default:
+            fprintf(TELECMD_OUT, "ERROR: Invalid Command found in Queue\n");
+            break;
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: reverseCmdQueue()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will reverse the command list so that the commands
+ *           with the least priority become the most prior commands and
+ *           update head pointer.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    None
+ *              OUT:   None
+ *------------------------------------------------------------------------------
+ * GLOBALS: pHeadTeleCmdQ (Head pointer of Queue)
+ *
+ *----------------------------------------------------------------------------*/
+static VOID reverseCmdQueue(VOID)
+{
+    TELE_CMD_LIST_t  *pCurPosNode = pHeadTeleCmdQ; /* Ptr for Queue Handling */
+    TELE_CMD_LIST_t  *pRefNode = NULL; /* Ptr for previous node handling */
+
+    while(pCurPosNode != NULL)
+    {
+        /* Reverse the list */
+        pRefNode = pCurPosNode->pPrevCmdNode;
+        pCurPosNode->pPrevCmdNode = pCurPosNode->pNextCmdNode;
+        pCurPosNode->pNextCmdNode = pRefNode;
+        pCurPosNode = pCurPosNode->pPrevCmdNode;
+    }
+     
+    /* check empty list and list with only one node before updating Head */
+    if(pRefNode != NULL )
+       pHeadTeleCmdQ = pRefNode->pPrevCmdNode;
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: executeCmdFromQueue()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will execute the command from the list and
+ *           after execution it will remove the command from the list.
+ *           Executed command is always the head, so it is popped right away
+ *           instead of left as tombstone in front of every later lookup.
+ *           Tombstones reaching the head are popped the same way.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    None
+ *              OUT:   None
+ *------------------------------------------------------------------------------
+ * GLOBALS: pHeadTeleCmdQ (Head pointer of Queue)
+ *          tombstoneCount (Number of deleted nodes pending for compaction)
+ *----------------------------------------------------------------------------*/
+static VOID executeCmdFromQueue(VOID)
+{
+    while (pHeadTeleCmdQ != NULL)
+    {
+        TELE_CMD_LIST_t *pCurPosNode = pHeadTeleCmdQ; /* Ptr for Queue Handling */
+        
+        /* Node deleted earlier, just release it */
+        if (pCurPosNode->isTombstone == TRUE)
+        {
+            tombstoneCount--;
+            unlinkNodeFromQueue(pCurPosNode);
+            continue;
+        }
+        
+        executeCmdNode(pCurPosNode);
+        
+        /* Delete the command from list as it is executed, it never deletes
+         * itself, so it is still the head */
+        unlinkNodeFromQueue(pCurPosNode);
+        
+        /* Targets deleted by DELETE commands are still tombstones */
+        if (isCompactionRequired() == TRUE)
+        {
+            compactCmdQueue();
+        }
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: executeCmdNode()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will execute one command node. Removing the
+ *           executed node from Queue is up to the caller.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    Address of command node
+ *              OUT:   None
+ *------------------------------------------------------------------------------
+ * GLOBALS: -
+ *
+ *----------------------------------------------------------------------------*/
+static VOID executeCmdNode(TELE_CMD_LIST_t *pCmdNode)
+{
+    switch (pCmdNode->teleCmdData.teleCmd)
+    {
+        case CMD_NEWCMD_WITH_LOW_PRIO:
+        case CMD_NEWCMD_WITH_USER_PRIO:
+            /* For Now, No action required for this command */
+            break;
+            
+        case CMD_DELETE_CMD_FROM_QUEUE:
+            /* if targetIdx is not own entryIdx, find and delete the node */
+            if(pCmdNode->teleCmdData.targetIdx != pCmdNode->teleCmdData.entryIdx)
+            {
+                deleteCmdDataFromQueue(pCmdNode->teleCmdData.targetIdx);
+            }
+            break;
+            
+        case CMD_MODIFY_CMD_DATA_IN_QUEUE:
+            /* modify the command data as per request */
+            modifyCmdDataInQueue(pCmdNode->teleCmdData.targetIdx, pCmdNode->teleCmdData.newCmdData);
+            break;
+            
+        case CMD_SORT_CMD_QUEUE:
+        case CMD_PRINT_CMDS:
+        case CMD_REVERSE_CMD_QUEUE:
+        default:
+            fprintf(TELECMD_OUT, "ERROR: Invalid Command found in Queue\n");
+            break;
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: removeNodeFromQueue()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will remove the node from Queue. In tombstone mode
+ *           node is only marked as deleted and freed later by compaction,
+ *           otherwise it is unlinked and freed immediately.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    Address of node to be removed
+ *              OUT:   None
+ *------------------------------------------------------------------------------
+ * GLOBALS: isTombstoneModeOn (Deletion mode)
+ *          tombstoneCount (Number of deleted nodes pending for compaction)
+ *----------------------------------------------------------------------------*/
+static VOID removeNodeFromQueue(TELE_CMD_LIST_t *pDelNode)
+{
+    if (isTombstoneModeOn == TRUE)
+    {
+        pDelNode->isTombstone = TRUE;
+        tombstoneCount++;
+    }
+    else
+    {
+        unlinkNodeFromQueue(pDelNode);
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: unlinkNodeFromQueue()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will unlink the node from its neighbour nodes and
+ *           free the memory of the node.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    Address of node to be freed
+ *              OUT:   None
+ *------------------------------------------------------------------------------
+ * GLOBALS: pHeadTeleCmdQ (Head pointer of Queue)
+ *          queueNodeCount (Number of nodes in Queue)
+ *----------------------------------------------------------------------------*/
+static VOID unlinkNodeFromQueue(TELE_CMD_LIST_t *pDelNode)
+{
+    if (pDelNode == pHeadTeleCmdQ)
+    {
+        pHeadTeleCmdQ = pDelNode->pNextCmdNode;
+    }
+    else
+    {
+        pDelNode->pPrevCmdNode->pNextCmdNode = pDelNode->pNextCmdNode;
+    }
+    
+    if (pDelNode->pNextCmdNode != NULL)
+    {
+        pDelNode->pNextCmdNode->pPrevCmdNode = pDelNode->pPrevCmdNode;
+    }
+    
+    /* Free the memory of the node */
+    free(pDelNode);
+    queueNodeCount--;
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: isCompactionRequired()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will check share of tombstones in the Queue against
+ *           TOMBSTONE_COMPACT_PCT.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    None
+ *              OUT:   None
+ * RETURN VALUE: TRUE if Queue should be compacted, else FALSE
+ *------------------------------------------------------------------------------
+ * GLOBALS: queueNodeCount (Number of nodes in Queue)
+ *          tombstoneCount (Number of deleted nodes pending for compaction)
+ *----------------------------------------------------------------------------*/
+static BOOL isCompactionRequired(VOID)
+{
+    return ((UINT64) tombstoneCount * 100 >
+            (UINT64) queueNodeCount * TOMBSTONE_COMPACT_PCT) ? TRUE : FALSE;
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: compactCmdQueue()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will walk the Queue once from head and unlink and
+ *           free all the tombstone nodes, relinking the live nodes in order.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    None
+ *              OUT:   None
+ *------------------------------------------------------------------------------
+ * GLOBALS: pHeadTeleCmdQ (Head pointer of Queue)
+ *          queueNodeCount (Number of nodes in Queue)
+ *          tombstoneCount (Number of deleted nodes pending for compaction)
+ *----------------------------------------------------------------------------*/
+static VOID compactCmdQueue(VOID)
+{
+    TELE_CMD_LIST_t *pCurPosNode = pHeadTeleCmdQ; /* Ptr for Queue Handling */
+    TELE_CMD_LIST_t *pLastLiveNode = NULL; /* Last node kept in the Queue */
+    
+    pHeadTeleCmdQ = NULL;
+    while (pCurPosNode != NULL)
+    {
+        TELE_CMD_LIST_t *pNextNode = pCurPosNode->pNextCmdNode; /* next node */
+        
+        if (pCurPosNode->isTombstone == TRUE)
+        {
+            free(pCurPosNode);
+            queueNodeCount--;
+        }
+        else
+        {
+            /* Append the live node after last kept node */
+            pCurPosNode->pPrevCmdNode = pLastLiveNode;
+            if (pLastLiveNode == NULL)
+            {
+                pHeadTeleCmdQ = pCurPosNode;
+            }
+            else
+            {
+                pLastLiveNode->pNextCmdNode = pCurPosNode;
+            }
+            pLastLiveNode = pCurPosNode;
+        }
+        pCurPosNode = pNextNode;
+    }
+    
+    if (pLastLiveNode != NULL)
+    {
+        pLastLiveNode->pNextCmdNode = NULL;
+    }
+    tombstoneCount = INVALID_VAL;
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: printTopKCmdsFromQueue()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will print the K commands with highest priority,
+ *           most urgent first. Queue is not changed.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    Number of commands (K)
+ *              OUT:   None
+ *------------------------------------------------------------------------------
+ * GLOBALS: -
+ *
+ *----------------------------------------------------------------------------*/
+static VOID printTopKCmdsFromQueue(UINT32 topCount)
+{
+    TOP_K_ENTRY_t *pTopKEntries = NULL; /* selected commands, most urgent first */
+    UINT32 numOfEntries = selectTopKCmdNodes(topCount, &pTopKEntries);
+    UINT32 entryIdx = INVALID_VAL; /* loop var for selected commands */
+    
+    for (entryIdx = 0; entryIdx < numOfEntries; entryIdx++)
+    {
+        printCmdNode(pTopKEntries[entryIdx].pCmdNode);
+    }
+    free(pTopKEntries);
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: executeTopKCmdsFromQueue()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will execute the K commands with highest priority,
+ *           most urgent first, and remove them from Queue. Rest of the Queue
+ *           stays in its order. Nodes are removed as tombstones while the
+ *           selection is in use, so a selected node deleted by an earlier
+ *           selected command is skipped instead of being freed under us.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    Number of commands (K)
+ *              OUT:   None
+ *------------------------------------------------------------------------------
+ * GLOBALS: isTombstoneModeOn (Deletion mode)
+ *          tombstoneCount (Number of deleted nodes pending for compaction)
+ *----------------------------------------------------------------------------*/
+static VOID executeTopKCmdsFromQueue(UINT32 topCount)
+{
+    TOP_K_ENTRY_t *pTopKEntries = NULL; /* selected commands, most urgent first */
+    UINT32 numOfEntries = selectTopKCmdNodes(topCount, &pTopKEntries);
+    UINT32 entryIdx = INVALID_VAL; /* loop var for selected commands */
+    BOOL holdTombstoneMode = isTombstoneModeOn; /* restore after execution */
+    
+    isTombstoneModeOn = TRUE;
+    for (entryIdx = 0; entryIdx < numOfEntries; entryIdx++)
+    {
+        TELE_CMD_LIST_t *pCmdNode = pTopKEntries[entryIdx].pCmdNode;
+        
+        if (pCmdNode->isTombstone == FALSE)
+        {
+            executeCmdNode(pCmdNode);
+            removeNodeFromQueue(pCmdNode);
+        }
+    }
+    isTombstoneModeOn = holdTombstoneMode;
+    free(pTopKEntries);
+    
+    if ((tombstoneCount != INVALID_VAL) &&
+        ((isTombstoneModeOn == FALSE) || (isCompactionRequired() == TRUE)))
+    {
+        compactCmdQueue();
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: selectTopKCmdNodes()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will select K most urgent commands in one pass
+ *           over the Queue, O(n log K). A min heap of size K keeps the
+ *           least urgent selected command at root, which is replaced when
+ *           a more urgent command is found. Higher priority is more urgent,
+ *           on same priority the command earlier in Queue is more urgent,
+ *           same as stable sort would order them. At the end the heap is
+ *           sorted in place so most urgent command comes first.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    Number of commands (K)
+ *              OUT:   Allocated array of selected commands (free by caller)
+ * RETURN VALUE: Number of selected commands
+ *------------------------------------------------------------------------------
+ * GLOBALS: pHeadTeleCmdQ (Head pointer of Queue)
+ *          queueNodeCount (Number of nodes in Queue)
+ *          tombstoneCount (Number of deleted nodes pending for compaction)
+ *----------------------------------------------------------------------------*/
+static UINT32 selectTopKCmdNodes(UINT32 topCount, TOP_K_ENTRY_t **ppTopKEntries)
+{
+    TELE_CMD_LIST_t *pCurPosNode = pHeadTeleCmdQ; /* Ptr for Queue Handling */
+    TOP_K_ENTRY_t *pTopKHeap = NULL; /* min heap of selected commands */
+    TOP_K_ENTRY_t curEntry = {NULL, INVALID_VAL}; /* entry of current node */
+    UINT32 heapSize = INVALID_VAL; /* commands in heap */
+    UINT32 liveNodeCount = queueNodeCount - tombstoneCount; /* commands in Queue */
+    
+    *ppTopKEntries = NULL;
+    if (topCount > liveNodeCount)
+    {
+        topCount = liveNodeCount;
+    }
+    if (topCount == INVALID_VAL)
+    {
+        return INVALID_VAL;
+    }
+    
+    pTopKHeap = (TOP_K_ENTRY_t *) malloc(topCount * sizeof(TOP_K_ENTRY_t));
+    if (pTopKHeap == NULL)
+    {
+        fprintf(TELECMD_OUT, "ERROR: Failed to assign dynamic memory for top K commands\n");
+        return INVALID_VAL;
+    }
+    
+    while (pCurPosNode != NULL)
+    {
+        if (pCurPosNode->isTombstone == FALSE)
+        {
+            curEntry.pCmdNode = pCurPosNode;
+            
+            if (heapSize < topCount)
+            {
+                /* Heap not full yet, insert and sift up */
+                UINT32 heapIdx = heapSize++;
+                
+                while ((heapIdx > 0) &&
+                       (isLessUrgentEntry(&curEntry, &pTopKHeap[(heapIdx - 1) / 2]) == TRUE))
+                {
+                    pTopKHeap[heapIdx] = pTopKHeap[(heapIdx - 1) / 2];
+                    heapIdx = (heapIdx - 1) / 2;
+                }
+                pTopKHeap[heapIdx] = curEntry;
+            }
+            else if (isLessUrgentEntry(&pTopKHeap[0], &curEntry) == TRUE)
+            {
+                /* Replace least urgent selected command */
+                pTopKHeap[0] = curEntry;
+                siftDownTopKHeap(pTopKHeap, heapSize, 0);
+            }
+        }
+        curEntry.queuePos++;
+        pCurPosNode = pCurPosNode->pNextCmdNode;
+    }
+    
+    /* Sort heap in place: least urgent moves to the end each round */
+    while (heapSize > 1)
+    {
+        TOP_K_ENTRY_t swapEntry = pTopKHeap[0];
+        
+        heapSize--;
+        pTopKHeap[0] = pTopKHeap[heapSize];
+        pTopKHeap[heapSize] = swapEntry;
+        siftDownTopKHeap(pTopKHeap, heapSize, 0);
+    }
+    
+    *ppTopKEntries = pTopKHeap;
+    return topCount;
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: isLessUrgentEntry()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will compare urgency of two selected commands.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    Address of two heap entries
+ *              OUT:   None
+ * RETURN VALUE: TRUE if first entry is less urgent than second, else FALSE
+ *------------------------------------------------------------------------------
+ * GLOBALS: -
+ *
+ *----------------------------------------------------------------------------*/
+static BOOL isLessUrgentEntry(const TOP_K_ENTRY_t *pEntryA, const TOP_K_ENTRY_t *pEntryB)
+{
+    UINT32 priorityA = pEntryA->pCmdNode->teleCmdData.cmdPriority;
+    UINT32 priorityB = pEntryB->pCmdNode->teleCmdData.cmdPriority;
+    
+    if (priorityA != priorityB)
+    {
+        return (priorityA < priorityB) ? TRUE : FALSE;
+    }
+    return (pEntryA->queuePos > pEntryB->queuePos) ? TRUE : FALSE;
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: siftDownTopKHeap()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will move heap entry down until both children are
+ *           more urgent, so least urgent entry stays at root.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    Heap, size of heap and index of entry to move
+ *              OUT:   None
+ *------------------------------------------------------------------------------
+ * GLOBALS: -
+ *
+ *----------------------------------------------------------------------------*/
+static VOID siftDownTopKHeap(TOP_K_ENTRY_t *pTopKHeap, UINT32 heapSize, UINT32 heapIdx)
+{
+    TOP_K_ENTRY_t holdEntry = pTopKHeap[heapIdx]; /* entry to move down */
+    
+    while (TRUE)
+    {
+        UINT32 childIdx = (2 * heapIdx) + 1; /* left child */
+        
+        if (childIdx >= heapSize)
+        {
+            break;
+        }
+        /* Take the less urgent child */
+        if (((childIdx + 1) < heapSize) &&
+            (isLessUrgentEntry(&pTopKHeap[childIdx + 1], &pTopKHeap[childIdx]) == TRUE))
+        {
+            childIdx++;
+        }
+        if (isLessUrgentEntry(&pTopKHeap[childIdx], &holdEntry) == FALSE)
+        {
+            break;
+        }
+        pTopKHeap[heapIdx] = pTopKHeap[childIdx];
+        heapIdx = childIdx;
+    }
+    pTopKHeap[heapIdx] = holdEntry;
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: executeCmdQueueParallel()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will execute the command list like
+ *           executeCmdFromQueue() but on all cores. A command and the command
+ *           its targetIdx points to can affect each other, so commands are
+ *           partitioned (union find) into groups connected by targetIdx.
+ *           Each group is applied in Queue order by one task and groups run
+ *           in parallel on the work stealing pool. Errors are collected per
+ *           command and printed in Queue order after all tasks are done, so
+ *           output and end state are same as sequential execution.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    None
+ *              OUT:   None
+ *------------------------------------------------------------------------------
+ * GLOBALS: pHeadTeleCmdQ (Head pointer of Queue)
+ *          queueNodeCount (Number of nodes in Queue)
+ *          tombstoneCount (Number of deleted nodes pending for compaction)
+ *----------------------------------------------------------------------------*/
+static VOID executeCmdQueueParallel(VOID)
+{
+    PARALLEL_EXEC_CTX_t execCtx = {NULL}; /* shared data of all tasks */
+    PARALLEL_EXEC_TASK_t *pExecTasks = NULL; /* group ranges per task */
+    TELECMD_TASK_t *pPoolTasks = NULL; /* tasks handed to the pool */
+    UINT32 *pGroupParent = NULL; /* scratch: union find parent */
+    UINT32 *pGroupOfPos = NULL; /* scratch: group of each position */
+    UINT32 numOfWorkers = telecmdPoolGetNumOfWorkers(); /* worker threads */
+    UINT32 numOfCmds = queueNodeCount - tombstoneCount; /* live commands */
+    UINT32 numOfEntryPosSlots = 1; /* entry Idx table, at most half full */
+    UINT32 numOfGroups = INVALID_VAL; /* independent command groups */
+    UINT32 numOfTasks = INVALID_VAL; /* tasks handed to the pool */
+    UINT32 cmdsPerTask = INVALID_VAL; /* commands to put in one task */
+    UINT32 queuePos = INVALID_VAL; /* loop var for positions */
+    UINT32 groupIdx = INVALID_VAL; /* loop var for groups */
+    
+    /* Thread handling does not pay off for small Queue */
+    if ((numOfCmds < PARALLEL_EXEC_MIN_CMDS) || (numOfWorkers == 1))
+    {
+        executeCmdFromQueue();
+        return;
+    }
+    
+    cmdsPerTask = numOfCmds / (numOfWorkers * PARALLEL_TASKS_PER_WORKER);
+    if (cmdsPerTask == INVALID_VAL)
+    {
+        cmdsPerTask = 1;
+    }
+    
+    /* Entry Idx table is sized by live commands, not by all commands ever
+     * queued, so it stays bounded for an endless ring and wrapped Idx */
+    while (numOfEntryPosSlots < numOfCmds)
+    {
+        numOfEntryPosSlots <<= 1;
+    }
+    numOfEntryPosSlots <<= 1;
+    execCtx.entryPosMask = numOfEntryPosSlots - 1;
+    execCtx.ppCmdNodes = (TELE_CMD_LIST_t **) malloc(numOfCmds * sizeof(TELE_CMD_LIST_t *));
+    execCtx.pEntryPosSlots = (ENTRY_POS_SLOT_t *) malloc(numOfEntryPosSlots * sizeof(ENTRY_POS_SLOT_t));
+    execCtx.pNextSamePos = (UINT32 *) malloc(numOfCmds * sizeof(UINT32));
+    execCtx.pGroupStart = (UINT32 *) calloc(numOfCmds + 1, sizeof(UINT32));
+    execCtx.pGroupMembers = (UINT32 *) malloc(numOfCmds * sizeof(UINT32));
+    execCtx.pIsAlive = (BOOL *) malloc(numOfCmds * sizeof(BOOL));
+    execCtx.pExecResult = (UINT8 *) calloc(numOfCmds, sizeof(UINT8));
+    pGroupParent = (UINT32 *) malloc(numOfCmds * sizeof(UINT32));
+    pGroupOfPos = (UINT32 *) malloc(numOfCmds * sizeof(UINT32));
+    pExecTasks = (PARALLEL_EXEC_TASK_t *) malloc(((numOfCmds / cmdsPerTask) + 1) * sizeof(PARALLEL_EXEC_TASK_t));
+    pPoolTasks = (TELECMD_TASK_t *) malloc(((numOfCmds / cmdsPerTask) + 1) * sizeof(TELECMD_TASK_t));
+    
+    if ((execCtx.ppCmdNodes == NULL) || (execCtx.pEntryPosSlots == NULL) ||
+        (execCtx.pNextSamePos == NULL) || (execCtx.pGroupStart == NULL) || (execCtx.pGroupMembers == NULL) ||
+        (execCtx.pIsAlive == NULL) || (execCtx.pExecResult == NULL) ||
+        (pGroupParent == NULL) || (pGroupOfPos == NULL) ||
+        (pExecTasks == NULL) || (pPoolTasks == NULL))
+    {
+        /* Not enough memory for parallel execution, fall back */
+        fprintf(TELECMD_OUT, "ERROR: Failed to assign dynamic memory for parallel execution\n");
+        executeCmdFromQueue();
+    }
+    else
+    {
+        numOfGroups = buildCmdGroups(&execCtx, numOfCmds, pGroupParent, pGroupOfPos);
+        
+        /* Pack neighbouring groups into tasks of about same size */
+        while (groupIdx < numOfGroups)
+        {
+            PARALLEL_EXEC_TASK_t *pExecTask = &pExecTasks[numOfTasks];
+            
+            pExecTask->pExecCtx = &execCtx;
+            pExecTask->firstGroup = groupIdx;
+            while ((groupIdx < numOfGroups) &&
+                   ((execCtx.pGroupStart[groupIdx] - execCtx.pGroupStart[pExecTask->firstGroup]) < cmdsPerTask))
+            {
+                groupIdx++;
+            }
+            pExecTask->endGroup = groupIdx;
+            pPoolTasks[numOfTasks].pTaskFn = runParallelExecTask;
+            pPoolTasks[numOfTasks].pTaskArg = pExecTask;
+            numOfTasks++;
+        }
+        
+        telecmdPoolRunTasks(pPoolTasks, numOfTasks, numOfWorkers);
+        
+        /* Report errors in Queue order, same as sequential execution */
+        for (queuePos = 0; queuePos < numOfCmds; queuePos++)
+        {
+            if (execCtx.pExecResult[queuePos] == EXEC_RESULT_NODE_NOT_FOUND)
+            {
+                fprintf(TELECMD_OUT, "ERROR: deleteCmdDataFromQueue: Node not found in Queue\n");
+            }
+            else if (execCtx.pExecResult[queuePos] == EXEC_RESULT_INVALID_CMD)
+            {
+                fprintf(TELECMD_OUT, "ERROR: Invalid Command found in Queue\n");
+            }
+        }
+        
+        /* Every command is either executed or deleted now */
+        for (queuePos = 0; queuePos < numOfCmds; queuePos++)
+        {
+            removeNodeFromQueue(execCtx.ppCmdNodes[queuePos]);
+        }
+        if (tombstoneCount != INVALID_VAL)
+        {
+            compactCmdQueue();
+        }
+    }
+    
+    free(execCtx.ppCmdNodes);
+    free(execCtx.pEntryPosSlots);
+    free(execCtx.pNextSamePos);
+    free(execCtx.pGroupStart);
+    free(execCtx.pGroupMembers);
+    free(execCtx.pIsAlive);
+    free(execCtx.pExecResult);
+    free(pGroupParent);
+    free(pGroupOfPos);
+    free(pExecTasks);
+    free(pPoolTasks);
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: buildCmdGroups()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will collect the live nodes in Queue order, join
+ *           every DELETE/MODIFY command with its target (union find) and
+ *           store the positions grouped, in Queue order inside each group.
+ *           Nodes sharing a wrapped entry Idx are joined too, so the target
+ *           can be resolved to first live one when the command runs.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    Parallel execution data, number of live commands,
+ *                     two scratch arrays of number of live commands
+ *              OUT:   Filled node, group start and group member arrays
+ * RETURN VALUE: Number of groups
+ *------------------------------------------------------------------------------
+ * GLOBALS: pHeadTeleCmdQ (Head pointer of Queue)
+ *
+ *----------------------------------------------------------------------------*/
+static UINT32 buildCmdGroups(PARALLEL_EXEC_CTX_t *pExecCtx, UINT32 numOfCmds,
+                             UINT32 *pGroupParent, UINT32 *pGroupOfPos)
+{
+    TELE_CMD_LIST_t *pCurPosNode = pHeadTeleCmdQ; /* Ptr for Queue Handling */
+    UINT32 numOfGroups = INVALID_VAL; /* independent command groups */
+    UINT32 queuePos = INVALID_VAL; /* loop var for positions */
+    UINT32 groupIdx = INVALID_VAL; /* loop var for groups */
+    
+    /* Collect live nodes in Queue order and index them by entry Idx */
+    memset(pExecCtx->pEntryPosSlots, 0xFF, (pExecCtx->entryPosMask + 1) * sizeof(ENTRY_POS_SLOT_t));
+    while (pCurPosNode != NULL)
+    {
+        if (pCurPosNode->isTombstone == FALSE)
+        {
+            pExecCtx->ppCmdNodes[queuePos] = pCurPosNode;
+            addCmdEntryPos(pExecCtx, pCurPosNode->teleCmdData.entryIdx, queuePos);
+            pExecCtx->pIsAlive[queuePos] = TRUE;
+            pExecCtx->pNextSamePos[queuePos] = INVALID_POS;
+            pGroupParent[queuePos] = queuePos;
+            queuePos++;
+        }
+        pCurPosNode = pCurPosNode->pNextCmdNode;
+    }
+    
+    /* Union command with its target and nodes with same entry Idx */
+    for (queuePos = 0; queuePos < numOfCmds; queuePos++)
+    {
+        TELECMD_CONFIG_t *pCmdData = &pExecCtx->ppCmdNodes[queuePos]->teleCmdData;
+        UINT32 targetPos = INVALID_POS; /* position of target command */
+        
+        if ((pCmdData->teleCmd == CMD_DELETE_CMD_FROM_QUEUE) ||
+            (pCmdData->teleCmd == CMD_MODIFY_CMD_DATA_IN_QUEUE))
+        {
+            targetPos = getCmdTargetPos(pExecCtx, pCmdData->targetIdx);
+        }
+        
+        if (targetPos != INVALID_POS)
+        {
+            joinCmdGroups(pGroupParent, queuePos, targetPos);
+        }
+        if (pExecCtx->pNextSamePos[queuePos] != INVALID_POS)
+        {
+            joinCmdGroups(pGroupParent, queuePos, pExecCtx->pNextSamePos[queuePos]);
+        }
     }
- 
-    /* store first second handling pointers into merge pointers */
-    pMergeA     = pFirstHandlerPtr;
-    pMergeB     = pSecondHandlerPtr;
-    pMergeEndA  = pFirstEndPtr;
-    pMergeEndB  = pSecondEndPtr->pNextCmdNode;
- 
-    /* Check Merge pointer location for first list and second list */
-    while (pMergeA != pMergeEndA && pMergeB != pMergeEndB)
+    
+    /* Parent is always at smaller position, so one forward pass flattens
+     * the trees and numbers the groups by their first command */
+    for (queuePos = 0; queuePos < numOfCmds; queuePos++)
     {
-        /* swap the node if priority of first list node is less than second */
-        if (pMergeA->pNextCmdNode->teleCmdData.cmdPriority < pMergeB->teleCmdData.cmdPriority)
+        pGroupParent[queuePos] = pGroupParent[pGroupParent[queuePos]];
+        if (pGroupParent[queuePos] == queuePos)
         {
-            TELE_CMD_LIST_t *pSwapNode = pMergeB->pNextCmdNode;
-            pMergeB->pNextCmdNode = pMergeA->pNextCmdNode;
-            pMergeA->pNextCmdNode = pMergeB;
-            pMergeB->pPrevCmdNode = pMergeA;
-            pMergeB->pNextCmdNode->pPrevCmdNode = pMergeB;
-            pMergeB = pSwapNode;
+            pGroupOfPos[queuePos] = numOfGroups++;
         }
-        pMergeA = pMergeA->pNextCmdNode;
+        else
+        {
+            pGroupOfPos[queuePos] = pGroupOfPos[pGroupParent[queuePos]];
+        }
+        pExecCtx->pGroupStart[pGroupOfPos[queuePos] + 1]++;
     }
     
-
-    if (pMergeA == pMergeEndA)
+    /* Counting sort of positions by group, keeps Queue order in group.
+     * Parent array is reused as fill cursor of each group */
+    for (groupIdx = 0; groupIdx < numOfGroups; groupIdx++)
     {
-        /* assign next of pFirstHandlerPtr to pSecondHandlerPtr because
-         * pSecondHandlerPtr may have some elements left out which are greater
-         * than the last value of pFirstHandlerPtr */
-        pMergeA->pNextCmdNode = pMergeB;
-        pMergeB->pPrevCmdNode = pMergeA;
+        pExecCtx->pGroupStart[groupIdx + 1] += pExecCtx->pGroupStart[groupIdx];
+        pGroupParent[groupIdx] = pExecCtx->pGroupStart[groupIdx];
     }
-    else
+    for (queuePos = 0; queuePos < numOfCmds; queuePos++)
     {
-        pSecondEndPtr = pFirstEndPtr;
+        pExecCtx->pGroupMembers[pGroupParent[pGroupOfPos[queuePos]]++] = queuePos;
     }
+    
+    return numOfGroups;
 }
 
 /*------------------------------------------------------------------------------
- * FUNCTION: swapHandlingPtr()
+ * FUNCTION: findCmdGroupRoot()
  *------------------------------------------------------------------------------
- * ABSTRACT: This function is used to swap pointers of first queue and
- *           pointers of second queue.
+ * ABSTRACT: This function will find root of the command group with path
+ *           halving.
  *------------------------------------------------------------------------------
  * PARAMETERS:
- *              IN:    None
+ *              IN:    Union find parent array, position of command
  *              OUT:   None
+ * RETURN VALUE: Position of root command
  *------------------------------------------------------------------------------
- * GLOBALS:
- *          pFirstHandlerPtr (Handling pointer for first part of queue),
- *          pFirstEndPtr (Handling pointer for first part of queue),
- *          pSecondHandlerPtr (Handling pointer for second part of queue),
- *          pSecondEndPtr(Handling pointer for second part of queue)
+ * GLOBALS: -
+ *
  *----------------------------------------------------------------------------*/
-static VOID swapHandlingPtr(VOID)
+static UINT32 findCmdGroupRoot(UINT32 *pGroupParent, UINT32 queuePos)
 {
-    TELE_CMD_LIST_t *pSwapNodePtr = NULL; /* temp pointer for swapping */
-    
-    /* Swap handler pointers*/
-    pSwapNodePtr = pFirstHandlerPtr;
-    pFirstHandlerPtr = pSecondHandlerPtr;
-    pSecondHandlerPtr = pSwapNodePtr;
-    /* Swap end pointers*/
-    pSwapNodePtr = pFirstEndPtr;
-    pFirstEndPtr = pSecondEndPtr;
-    pSecondEndPtr = pSwapNodePtr;
+    while (pGroupParent[queuePos] != queuePos)
+    {
+        pGroupParent[queuePos] = pGroupParent[pGroupParent[queuePos]];
+        queuePos = pGroupParent[queuePos];
+    }
+    return queuePos;
 }
 
 /*------------------------------------------------------------------------------
- * FUNCTION: modifyCmdDataInQueue()
+ * FUNCTION: joinCmdGroups()
  *------------------------------------------------------------------------------
- * ABSTRACT: This function will find anf modify the command data using entry idx
- *           of the node.
+ * ABSTRACT: This function will join groups of two commands, root at smaller
+ *           position becomes the root of joined group.
  *------------------------------------------------------------------------------
  * PARAMETERS:
- *              IN:    Entry Idx and New Data
+ *              IN:    Union find parent array, positions of both commands
  *              OUT:   None
  *------------------------------------------------------------------------------
- * GLOBALS: pHeadTeleCmdQ (Head pointer of Queue)
+ * GLOBALS: -
+ *
  *----------------------------------------------------------------------------*/
-static VOID modifyCmdDataInQueue(UINT32 refEntryIdx, UINT32 refNewData)
+static VOID joinCmdGroups(UINT32 *pGroupParent, UINT32 firstPos, UINT32 secondPos)
 {
-    TELE_CMD_LIST_t *pCurPosNode = pHeadTeleCmdQ; /* Ptr for Queue Handling */
-    while(pCurPosNode != NULL)
+    UINT32 firstRoot = findCmdGroupRoot(pGroupParent, firstPos);
+    UINT32 secondRoot = findCmdGroupRoot(pGroupParent, secondPos);
+    
+    if (firstRoot < secondRoot)
     {
-        /* Search for entry Idx and update the new data in to command node */
-        if(pCurPosNode->teleCmdData.entryIdx == refEntryIdx)
-        {
-            pCurPosNode->teleCmdData.cmdData = refNewData;
-            return;
-        }
-        pCurPosNode = pCurPosNode->pNextCmdNode;
+        pGroupParent[secondRoot] = firstRoot;
+    }
+    else
+    {
+        pGroupParent[firstRoot] = secondRoot;
     }
-    return;
 }
 
 /*------------------------------------------------------------------------------
- * FUNCTION:   printCmdDataQueue()
+ * FUNCTION: addCmdEntryPos()
  *------------------------------------------------------------------------------
- * ABSTRACT: This function is used to print the commands from queue based on
- *           command id.
+ * ABSTRACT: This function will add entry Idx of live node to the table
+ *           (open addressing, linear probing). If entry Idx is already in
+ *           the table (Idx wrapped around), node is appended to the chain
+ *           of nodes with that Idx, which is kept in Queue order.
  *------------------------------------------------------------------------------
  * PARAMETERS:
- *              IN:    None
+ *              IN:    Parallel execution data, entry Idx, position of node
  *              OUT:   None
  *------------------------------------------------------------------------------
- * GLOBALS: pHeadTeleCmdQ (Head pointer of Queue)
+ * GLOBALS: -
  *
  *----------------------------------------------------------------------------*/
-static VOID printCmdDataQueue(VOID)
+static VOID addCmdEntryPos(PARALLEL_EXEC_CTX_t *pExecCtx, UINT32 entryIdx, UINT32 queuePos)
 {
-    TELE_CMD_LIST_t  *pCurPosNode = pHeadTeleCmdQ; /* Ptr for Queue Handling */
+    UINT32 slotIdx = (entryIdx * ENTRY_POS_HASH_MUL) & pExecCtx->entryPosMask;
     
-    while (pCurPosNode != NULL)
+    /* Table is at most half full, so a free slot is always found */
+    while (pExecCtx->pEntryPosSlots[slotIdx].queuePos != INVALID_POS)
     {
-        switch(pCurPosNode->teleCmdData.teleCmd)
+        if (pExecCtx->pEntryPosSlots[slotIdx].entryIdx == entryIdx)
         {
-            case CMD_NEWCMD_WITH_LOW_PRIO:
-                /* Print entry Idx, priority and data of the node */
-                printf("(%u, %u, %u)\n", pCurPosNode->teleCmdData.entryIdx,
-                                         pCurPosNode->teleCmdData.cmdPriority,
-                                         pCurPosNode->teleCmdData.cmdData);
-                break;
-                
-            case CMD_NEWCMD_WITH_USER_PRIO:
-                /* Print entry Idx, priority and data of the node */
-                printf("(%u, %u, %u)\n", pCurPosNode->teleCmdData.entryIdx,
-                                         pCurPosNode->teleCmdData.cmdPriority,
-                                         pCurPosNode->teleCmdData.cmdData);
-                break;
-                
-            case CMD_DELETE_CMD_FROM_QUEUE:
-                /* Print entry Idx and Target Idx which we want to detele */
-                printf("(%u, %u)\n", pCurPosNode->teleCmdData.entryIdx,
-                                     pCurPosNode->teleCmdData.targetIdx);
-                break;
-                
-            case CMD_MODIFY_CMD_DATA_IN_QUEUE:
-                /* Print entry Idx, Target Idx and new data */
-                printf("(%u, %u, %u)\n", pCurPosNode->teleCmdData.entryIdx,
-                                         pCurPosNode->teleCmdData.targetIdx,
-                                         pCurPosNode->teleCmdData.newCmdData);
-                break;
-                
-            case CMD_SORT_CMD_QUEUE:
-            case CMD_PRINT_CMDS:
-            case CMD_REVERSE_CMD_QUEUE:
-            default:
-                printf("ERROR: Invalid Command found in Queue\n");
-                break;
+            pExecCtx->pNextSamePos[pExecCtx->pEntryPosSlots[slotIdx].lastPos] = queuePos;
+            pExecCtx->pEntryPosSlots[slotIdx].lastPos = queuePos;
+            return;
         }
-        pCurPosNode = pCurPosNode->pNextCmdNode;
+        slotIdx = (slotIdx + 1) & pExecCtx->entryPosMask;
     }
+    pExecCtx->pEntryPosSlots[slotIdx].entryIdx = entryIdx;
+    pExecCtx->pEntryPosSlots[slotIdx].queuePos = queuePos;
+    pExecCtx->pEntryPosSlots[slotIdx].lastPos = queuePos;
 }
 
 /*------------------------------------------------------------------------------
- * FUNCTION: reverseCmdQueue()
+ * FUNCTION: getCmdTargetPos()
  *------------------------------------------------------------------------------
- * ABSTRACT: This function will reverse the command list so that the commands
- *           with the least priority become the most prior commands and
- *           update head pointer.
+ * ABSTRACT: This function will map target entry Idx to position of first
+ *           live node with that Idx, same node as sequential search from
+ *           head would find. Nodes sharing the Idx are in the group of the
+ *           caller, so their alive state is not changed by other tasks.
  *------------------------------------------------------------------------------
  * PARAMETERS:
- *              IN:    None
+ *              IN:    Parallel execution data, target entry Idx
  *              OUT:   None
+ * RETURN VALUE: Position of target node, INVALID_POS if it is not in Queue
  *------------------------------------------------------------------------------
- * GLOBALS: pHeadTeleCmdQ (Head pointer of Queue)
+ * GLOBALS: -
  *
  *----------------------------------------------------------------------------*/
-static VOID reverseCmdQueue(VOID)
+static UINT32 getCmdTargetPos(const PARALLEL_EXEC_CTX_t *pExecCtx, UINT32 targetIdx)
 {
-    TELE_CMD_LIST_t  *pCurPosNode = pHeadTeleCmdQ; /* Ptr for Queue Handling */
-    TELE_CMD_LIST_t  *pRefNode = NULL; /* Ptr for previous node handling */
-
-    while(pCurPosNode != NULL)
+    UINT32 slotIdx = (targetIdx * ENTRY_POS_HASH_MUL) & pExecCtx->entryPosMask;
+    
+    while (pExecCtx->pEntryPosSlots[slotIdx].queuePos != INVALID_POS)
     {
-        /* Reverse the list */
-        pRefNode = pCurPosNode->pPrevCmdNode;
-        pCurPosNode->pPrevCmdNode = pCurPosNode->pNextCmdNode;
-        pCurPosNode->pNextCmdNode = pRefNode;
-        pCurPosNode = pCurPosNode->pPrevCmdNode;
+        if (pExecCtx->pEntryPosSlots[slotIdx].entryIdx == targetIdx)
+        {
+            UINT32 targetPos = pExecCtx->pEntryPosSlots[slotIdx].queuePos;
+            
+            while ((targetPos != INVALID_POS) && (pExecCtx->pIsAlive[targetPos] == FALSE))
+            {
+                targetPos = pExecCtx->pNextSamePos[targetPos];
+            }
+            return targetPos;
+        }
+        slotIdx = (slotIdx + 1) & pExecCtx->entryPosMask;
     }
-     
-    /* check empty list and list with only one node before updating Head */
-    if(pRefNode != NULL )
-       pHeadTeleCmdQ = pRefNode->pPrevCmdNode;
+    return INVALID_POS;
 }
 
 /*------------------------------------------------------------------------------
- * FUNCTION: executeCmdFromQueue()
+ * FUNCTION: runParallelExecTask()
  *------------------------------------------------------------------------------
- * ABSTRACT: This function will execute the command from the list and
- *           after execution it will remove the command from the list.
+ * ABSTRACT: This function will apply the commands of its groups in Queue
+ *           order. Executed and deleted commands are only marked as not
+ *           alive, Queue itself is not touched by the tasks.
  *------------------------------------------------------------------------------
  * PARAMETERS:
- *              IN:    None
+ *              IN:    Address of PARALLEL_EXEC_TASK_t
  *              OUT:   None
  *------------------------------------------------------------------------------
- * GLOBALS: pHeadTeleCmdQ (Head pointer of Queue)
+ * GLOBALS: -
  *
  *----------------------------------------------------------------------------*/
-static VOID executeCmdFromQueue(VOID)
+static VOID runParallelExecTask(VOIDPTR pTaskArg)
 {
-    TELE_CMD_LIST_t *pCurPosNode = pHeadTeleCmdQ; /* Ptr for Queue Handling */
-    TELE_CMD_LIST_t *pHoldDelPos = NULL; /* Ptr for remove the node from Queue */
+    PARALLEL_EXEC_TASK_t *pExecTask = (PARALLEL_EXEC_TASK_t *) pTaskArg;
+    PARALLEL_EXEC_CTX_t *pExecCtx = pExecTask->pExecCtx;
+    UINT32 memberIdx = pExecCtx->pGroupStart[pExecTask->firstGroup];
+    UINT32 endMemberIdx = pExecCtx->pGroupStart[pExecTask->endGroup];
     
-    while (pCurPosNode != NULL)
+    /* Groups of the task are contiguous in member array */
+    for (; memberIdx < endMemberIdx; memberIdx++)
     {
-        switch (pCurPosNode->teleCmdData.teleCmd)
+        UINT32 queuePos = pExecCtx->pGroupMembers[memberIdx];
+        TELECMD_CONFIG_t *pCmdData = &pExecCtx->ppCmdNodes[queuePos]->teleCmdData;
+        UINT32 targetPos = INVALID_POS; /* position of target command */
+        
+        /* Deleted by earlier command of the group */
+        if (pExecCtx->pIsAlive[queuePos] == FALSE)
+        {
+            continue;
+        }
+        
+        switch (pCmdData->teleCmd)
         {
             case CMD_NEWCMD_WITH_LOW_PRIO:
             case CMD_NEWCMD_WITH_USER_PRIO:
@@ -617,42 +2178,316 @@ static VOID executeCmdFromQueue(VOID)
                 
             case CMD_DELETE_CMD_FROM_QUEUE:
                 /* if targetIdx is not own entryIdx, find and delete the node */
-                if(pCurPosNode->teleCmdData.targetIdx != pCurPosNode->teleCmdData.entryIdx)
+                if (pCmdData->targetIdx != pCmdData->entryIdx)
                 {
-                    deleteCmdDataFromQueue(pCurPosNode->teleCmdData.targetIdx);
+                    targetPos = getCmdTargetPos(pExecCtx, pCmdData->targetIdx);
+                    if (targetPos == INVALID_POS)
+                    {
+                        pExecCtx->pExecResult[queuePos] = EXEC_RESULT_NODE_NOT_FOUND;
+                    }
+                    else
+                    {
+                        pExecCtx->pIsAlive[targetPos] = FALSE;
+                    }
                 }
                 break;
                 
             case CMD_MODIFY_CMD_DATA_IN_QUEUE:
                 /* modify the command data as per request */
-                modifyCmdDataInQueue(pCurPosNode->teleCmdData.targetIdx, pCurPosNode->teleCmdData.newCmdData);
+                targetPos = getCmdTargetPos(pExecCtx, pCmdData->targetIdx);
+                if (targetPos != INVALID_POS)
+                {
+                    pExecCtx->ppCmdNodes[targetPos]->teleCmdData.cmdData = pCmdData->newCmdData;
+                }
                 break;
                 
-            case CMD_SORT_CMD_QUEUE:
-            case CMD_PRINT_CMDS:
-            case CMD_REVERSE_CMD_QUEUE:
             default:
-                printf("ERROR: Invalid Command found in Queue\n");
+                pExecCtx->pExecResult[queuePos] = EXEC_RESULT_INVALID_CMD;
                 break;
         }
-       
-        /*  Hold current position before next position so we can delete it */
-        pHoldDelPos = pCurPosNode;
+        
+        /* Executed command leaves the Queue */
+        pExecCtx->pIsAlive[queuePos] = FALSE;
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: sortTeleCmdQueueParallel()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will sort the Queue by priority (highest first)
+ *           on given workers. Nodes are copied to an array which is split in
+ *           one segment per worker, each segment is merge sorted by its task.
+ *           Then sorted runs are merged pairwise until one run is left. In
+ *           every round output of each pair is split in equal parts by merge
+ *           path, so all workers have work even in the last round. Merge
+ *           takes from the earlier run on same priority, so the sort is
+ *           stable. At the end the Queue is relinked in array order.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    Length of Queue (no tombstones), number of workers
+ *              OUT:   None
+ * RETURN VALUE: FALSE if arrays could not be allocated, Queue is unchanged
+ *------------------------------------------------------------------------------
+ * GLOBALS: pHeadTeleCmdQ (Head pointer of Queue)
+ *
+ *----------------------------------------------------------------------------*/
+static BOOL sortTeleCmdQueueParallel(UINT32 lenOfQueue, UINT32 numOfWorkers)
+{
+    TELE_CMD_LIST_t **ppSrcNodes = NULL; /* nodes, holds sorted runs */
+    TELE_CMD_LIST_t **ppDstNodes = NULL; /* nodes, receives merged runs */
+    UINT32 *pRunStart = NULL; /* start of each sorted run, plus end */
+    PARALLEL_MERGE_TASK_t *pMergeTasks = NULL; /* tasks of one round */
+    TELECMD_TASK_t *pPoolTasks = NULL; /* tasks handed to the pool */
+    TELE_CMD_LIST_t *pCurPosNode = pHeadTeleCmdQ; /* Ptr for Queue Handling */
+    UINT32 numOfRuns = numOfWorkers; /* sorted runs left */
+    UINT32 diagPerTask = (lenOfQueue + numOfWorkers - 1) / numOfWorkers;
+    UINT32 maxNumOfTasks = (2 * numOfWorkers) + 1; /* tasks of one round */
+    UINT32 queuePos = INVALID_VAL; /* loop var for positions */
+    UINT32 runIdx = INVALID_VAL; /* loop var for runs */
+    
+    ppSrcNodes = (TELE_CMD_LIST_t **) malloc(lenOfQueue * sizeof(TELE_CMD_LIST_t *));
+    ppDstNodes = (TELE_CMD_LIST_t **) malloc(lenOfQueue * sizeof(TELE_CMD_LIST_t *));
+    pRunStart = (UINT32 *) malloc((numOfRuns + 1) * sizeof(UINT32));
+    pMergeTasks = (PARALLEL_MERGE_TASK_t *) malloc(maxNumOfTasks * sizeof(PARALLEL_MERGE_TASK_t));
+    pPoolTasks = (TELECMD_TASK_t *) malloc(maxNumOfTasks * sizeof(TELECMD_TASK_t));
+    
+    if ((ppSrcNodes == NULL) || (ppDstNodes == NULL) || (pRunStart == NULL) ||
+        (pMergeTasks == NULL) || (pPoolTasks == NULL))
+    {
+        free(ppSrcNodes);
+        free(ppDstNodes);
+        free(pRunStart);
+        free(pMergeTasks);
+        free(pPoolTasks);
+        return FALSE;
+    }
+    
+    for (queuePos = 0; queuePos < lenOfQueue; queuePos++)
+    {
+        ppSrcNodes[queuePos] = pCurPosNode;
         pCurPosNode = pCurPosNode->pNextCmdNode;
+    }
+    
+    /* Sort one segment per worker, sorted segment is left in source array */
+    for (runIdx = 0; runIdx <= numOfRuns; runIdx++)
+    {
+        pRunStart[runIdx] = (UINT32) (((UINT64) lenOfQueue * runIdx) / numOfRuns);
+    }
+    for (runIdx = 0; runIdx < numOfRuns; runIdx++)
+    {
+        pMergeTasks[runIdx].ppSrcNodes = ppSrcNodes;
+        pMergeTasks[runIdx].ppDstNodes = ppDstNodes;
+        pMergeTasks[runIdx].firstBegin = pRunStart[runIdx];
+        pMergeTasks[runIdx].secondEnd = pRunStart[runIdx + 1];
+        pPoolTasks[runIdx].pTaskFn = runSegmentSortTask;
+        pPoolTasks[runIdx].pTaskArg = &pMergeTasks[runIdx];
+    }
+    telecmdPoolRunTasks(pPoolTasks, numOfRuns, numOfWorkers);
+    
+    /* Merge neighbouring runs pairwise until one run is left */
+    while (numOfRuns > 1)
+    {
+        TELE_CMD_LIST_t **ppSwapNodes = NULL; /* to swap source and destination */
+        UINT32 numOfTasks = INVALID_VAL; /* tasks of this round */
+        
+        for (runIdx = 0; runIdx < numOfRuns; runIdx += 2)
+        {
+            UINT32 firstBegin = pRunStart[runIdx];
+            UINT32 firstEnd = pRunStart[runIdx + 1];
+            UINT32 secondEnd = (runIdx + 2 <= numOfRuns) ? pRunStart[runIdx + 2] : firstEnd;
+            UINT32 diagIdx = INVALID_VAL; /* loop var for output ranges */
+            
+            /* Split output of this pair, last run without pair is copied */
+            do
+            {
+                PARALLEL_MERGE_TASK_t *pMergeTask = &pMergeTasks[numOfTasks];
+                
+                pMergeTask->ppSrcNodes = ppSrcNodes;
+                pMergeTask->ppDstNodes = ppDstNodes;
+                pMergeTask->firstBegin = firstBegin;
+                pMergeTask->firstEnd = firstEnd;
+                pMergeTask->secondEnd = secondEnd;
+                pMergeTask->diagBegin = diagIdx;
+                diagIdx += diagPerTask;
+                if (diagIdx > secondEnd - firstBegin)
+                {
+                    diagIdx = secondEnd - firstBegin;
+                }
+                pMergeTask->diagEnd = diagIdx;
+                pPoolTasks[numOfTasks].pTaskFn = runMergePathTask;
+                pPoolTasks[numOfTasks].pTaskArg = pMergeTask;
+                numOfTasks++;
+            } while (diagIdx < secondEnd - firstBegin);
+            
+            /* Merged run starts where first run of the pair started */
+            pRunStart[runIdx / 2] = firstBegin;
+        }
+        numOfRuns = (numOfRuns + 1) / 2;
+        pRunStart[numOfRuns] = lenOfQueue;
+        
+        telecmdPoolRunTasks(pPoolTasks, numOfTasks, numOfWorkers);
+        
+        ppSwapNodes = ppSrcNodes;
+        ppSrcNodes = ppDstNodes;
+        ppDstNodes = ppSwapNodes;
+    }
+    
+    /* Relink the Queue in sorted order */
+    pHeadTeleCmdQ = ppSrcNodes[0];
+    for (queuePos = 0; queuePos < lenOfQueue; queuePos++)
+    {
+        ppSrcNodes[queuePos]->pPrevCmdNode = (queuePos > 0) ? ppSrcNodes[queuePos - 1] : NULL;
+        ppSrcNodes[queuePos]->pNextCmdNode = (queuePos + 1 < lenOfQueue) ? ppSrcNodes[queuePos + 1] : NULL;
+    }
+    
+    free(ppSrcNodes);
+    free(ppDstNodes);
+    free(pRunStart);
+    free(pMergeTasks);
+    free(pPoolTasks);
+    return TRUE;
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: runSegmentSortTask()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will sort one segment [firstBegin, secondEnd) of
+ *           source array with bottom up merge sort, using same range of
+ *           destination array as scratch. Sorted segment ends in source.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    Address of PARALLEL_MERGE_TASK_t
+ *              OUT:   None
+ *------------------------------------------------------------------------------
+ * GLOBALS: -
+ *
+ *----------------------------------------------------------------------------*/
+static VOID runSegmentSortTask(VOIDPTR pTaskArg)
+{
+    PARALLEL_MERGE_TASK_t *pSegTask = (PARALLEL_MERGE_TASK_t *) pTaskArg;
+    PARALLEL_MERGE_TASK_t mergeTask = *pSegTask; /* merge of two runs */
+    UINT32 segBegin = pSegTask->firstBegin; /* segment start */
+    UINT32 segEnd = pSegTask->secondEnd; /* segment end */
+    UINT32 runWidth = INVALID_VAL; /* length of sorted runs */
     
-        /* Delete the command from list as it is executed */
-        if(pHoldDelPos != NULL)
+    for (runWidth = 1; runWidth < segEnd - segBegin; runWidth *= 2)
+    {
+        TELE_CMD_LIST_t **ppSwapNodes = NULL; /* to swap source and destination */
+        
+        for (mergeTask.firstBegin = segBegin; mergeTask.firstBegin < segEnd;
+             mergeTask.firstBegin += 2 * runWidth)
         {
-            if (pHoldDelPos == pHeadTeleCmdQ)
+            mergeTask.firstEnd = mergeTask.firstBegin + runWidth;
+            if (mergeTask.firstEnd > segEnd)
             {
-                pHeadTeleCmdQ = pHoldDelPos->pNextCmdNode;
+                mergeTask.firstEnd = segEnd;
             }
-            else
+            mergeTask.secondEnd = mergeTask.firstEnd + runWidth;
+            if (mergeTask.secondEnd > segEnd)
             {
-                pHoldDelPos->pPrevCmdNode->pNextCmdNode = pHoldDelPos->pNextCmdNode;
+                mergeTask.secondEnd = segEnd;
             }
-            /* Free the memory of the node */
-            free(pHoldDelPos);
+            mergeTask.diagBegin = INVALID_VAL;
+            mergeTask.diagEnd = mergeTask.secondEnd - mergeTask.firstBegin;
+            runMergePathTask(&mergeTask);
+        }
+        
+        ppSwapNodes = mergeTask.ppSrcNodes;
+        mergeTask.ppSrcNodes = mergeTask.ppDstNodes;
+        mergeTask.ppDstNodes = ppSwapNodes;
+    }
+    
+    /* Odd number of passes leaves the result in scratch, copy it back */
+    if (mergeTask.ppSrcNodes != pSegTask->ppSrcNodes)
+    {
+        memcpy(&pSegTask->ppSrcNodes[segBegin], &mergeTask.ppSrcNodes[segBegin],
+               (segEnd - segBegin) * sizeof(TELE_CMD_LIST_t *));
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: runMergePathTask()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will write output range [diagBegin, diagEnd) of
+ *           merging two neighbouring sorted runs. Start of the range in both
+ *           runs is found by merge path search, so tasks of same pair can run
+ *           in parallel without sharing anything.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    Address of PARALLEL_MERGE_TASK_t
+ *              OUT:   None
+ *------------------------------------------------------------------------------
+ * GLOBALS: -
+ *
+ *----------------------------------------------------------------------------*/
+static VOID runMergePathTask(VOIDPTR pTaskArg)
+{
+    PARALLEL_MERGE_TASK_t *pMergeTask = (PARALLEL_MERGE_TASK_t *) pTaskArg;
+    TELE_CMD_LIST_t **ppSrcNodes = pMergeTask->ppSrcNodes;
+    UINT32 firstPos = pMergeTask->firstBegin + findMergePathSplit(ppSrcNodes,
+                      pMergeTask->firstBegin, pMergeTask->firstEnd,
+                      pMergeTask->secondEnd, pMergeTask->diagBegin);
+    UINT32 secondPos = pMergeTask->firstEnd + (pMergeTask->diagBegin -
+                       (firstPos - pMergeTask->firstBegin));
+    UINT32 outPos = pMergeTask->firstBegin + pMergeTask->diagBegin;
+    UINT32 outEnd = pMergeTask->firstBegin + pMergeTask->diagEnd;
+    
+    for (; outPos < outEnd; outPos++)
+    {
+        /* Take from first run on same priority to keep the sort stable */
+        if ((secondPos >= pMergeTask->secondEnd) ||
+            ((firstPos < pMergeTask->firstEnd) &&
+             (ppSrcNodes[firstPos]->teleCmdData.cmdPriority >=
+              ppSrcNodes[secondPos]->teleCmdData.cmdPriority)))
+        {
+            pMergeTask->ppDstNodes[outPos] = ppSrcNodes[firstPos++];
+        }
+        else
+        {
+            pMergeTask->ppDstNodes[outPos] = ppSrcNodes[secondPos++];
+        }
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: findMergePathSplit()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will find how many nodes of first run are among
+ *           first diagIdx nodes of merged output, with binary search along
+ *           the diagonal of merge path.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    Array, first run [firstBegin, firstEnd), second run
+ *                     [firstEnd, secondEnd), output position (diagonal)
+ *              OUT:   None
+ * RETURN VALUE: Number of nodes taken from first run
+ *------------------------------------------------------------------------------
+ * GLOBALS: -
+ *
+ *----------------------------------------------------------------------------*/
+static UINT32 findMergePathSplit(TELE_CMD_LIST_t **ppSrcNodes, UINT32 firstBegin,
+                                 UINT32 firstEnd, UINT32 secondEnd, UINT32 diagIdx)
+{
+    UINT32 lenOfFirst = firstEnd - firstBegin;
+    UINT32 lenOfSecond = secondEnd - firstEnd;
+    UINT32 lowIdx = (diagIdx > lenOfSecond) ? (diagIdx - lenOfSecond) : INVALID_VAL;
+    UINT32 highIdx = (diagIdx < lenOfFirst) ? diagIdx : lenOfFirst;
+    
+    while (lowIdx < highIdx)
+    {
+        UINT32 midIdx = lowIdx + ((highIdx - lowIdx) / 2);
+        
+        /* Is node midIdx of first run merged before node of second run
+         * on the other side of the diagonal */
+        if (ppSrcNodes[firstBegin + midIdx]->teleCmdData.cmdPriority >=
+            ppSrcNodes[firstEnd + diagIdx - 1 - midIdx]->teleCmdData.cmdPriority)
+        {
+            lowIdx = midIdx + 1;
+        }
+        else
+        {
+            highIdx = midIdx;
         }
     }
+    return lowIdx;
 }
@@ -24,6 +24,9 @@ typedef enum
     CMD_PRINT_CMDS,                         //5
     CMD_REVERSE_CMD_QUEUE,                  //6
     CMD_EXECUTE_CMDS,                       //7
+    CMD_EXECUTE_TOP_K_CMDS,                 //8
+    CMD_PRINT_TOP_K_CMDS,                   //9
+    CMD_PARALLEL_EXECUTE_CMDS,              //10
 
     MAX_CMDS,
 }TELECMD_LIST_e;
@@ -45,11 +48,17 @@ struct teleCmdNode
     TELECMD_CONFIG_t    teleCmdData;    // TeleCommand Data
     struct teleCmdNode  *pNextCmdNode;  // pointer to point next node
     struct teleCmdNode  *pPrevCmdNode;  // pointer to point prev node
+    BOOL                isTombstone;    // deleted, waiting for compaction
 };
 
 typedef struct teleCmdNode TELE_CMD_LIST_t;
 
+/* Output of the thread, shard output or stdout */
+extern __thread FILE *pTeleCmdOutFile;
+#define TELECMD_OUT     ((pTeleCmdOutFile != NULL) ? pTeleCmdOutFile : stdout)
 
 VOID telecmdInterpreter(VOID);
+BOOL telecmdInterpreterShmRing(const CHAR *pRingName);
+BOOL telecmdInterpreterFiles(const CHAR **ppFilePaths, UINT32 numOfFiles, BOOL isMergeRequired);
 
 #endif /* telecmd_interpreter_h */
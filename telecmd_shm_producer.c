@@ -0,0 +1,159 @@
+//
+//  telecmd_shm_producer.c
+//  Telecommand Interpreter
+//
+//  Minimal ground station front end: reads a command batch file and hands
+//  the commands over to the interpreter through the shared memory ring.
+//  telecmdShmProducer /ringName [batchFile]
+//
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "telecmd_shm_ring.h"
+
+#define PRODUCER_RING_CAPACITY  1024    /* records in ring, power of 2 */
+#define PRODUCER_BATCH_SIZE     64      /* records published at once */
+#define PRODUCER_SLEEP_NSEC     10000   /* wait for consumer, 10 us */
+#define PRODUCER_WAIT_TIMEOUT_SEC 10    /* give up if consumer makes no progress */
+#define MAX_LENGTH              256
+
+/* Parse next valid command line of batch file into record */
+static BOOL readNextCmdRecord(FILE *pCmdFile, TELECMD_CONFIG_t *pCmdRecord)
+{
+    char cmdBuffer[MAX_LENGTH] = {0};
+
+    while (fgets(cmdBuffer, MAX_LENGTH, pCmdFile))
+    {
+        TELECMD_CONFIG_t parseCmdData = {0};
+
+        cmdBuffer[strlen(cmdBuffer) - 1] = '\0';
+        sscanf(cmdBuffer, "%u", &parseCmdData.teleCmd);
+
+        switch (parseCmdData.teleCmd)
+        {
+            case CMD_NEWCMD_WITH_LOW_PRIO:
+            case CMD_EXECUTE_TOP_K_CMDS:
+            case CMD_PRINT_TOP_K_CMDS:
+                sscanf(cmdBuffer, "%u %u", &parseCmdData.teleCmd, &parseCmdData.cmdData);
+                break;
+
+            case CMD_NEWCMD_WITH_USER_PRIO:
+                sscanf(cmdBuffer, "%u %u %u", &parseCmdData.teleCmd,
+                       &parseCmdData.cmdPriority, &parseCmdData.cmdData);
+                break;
+
+            case CMD_DELETE_CMD_FROM_QUEUE:
+                sscanf(cmdBuffer, "%u %u", &parseCmdData.teleCmd, &parseCmdData.targetIdx);
+                break;
+
+            case CMD_MODIFY_CMD_DATA_IN_QUEUE:
+                sscanf(cmdBuffer, "%u %u %u", &parseCmdData.teleCmd,
+                       &parseCmdData.targetIdx, &parseCmdData.newCmdData);
+                break;
+
+            case CMD_PRINT_CMDS:
+            case CMD_SORT_CMD_QUEUE:
+            case CMD_REVERSE_CMD_QUEUE:
+            case CMD_EXECUTE_CMDS:
+            case CMD_PARALLEL_EXECUTE_CMDS:
+                break;
+
+            default:
+                printf("ERROR: Invalid Command Received [%s]\n", cmdBuffer);
+                continue;
+        }
+
+        *pCmdRecord = parseCmdData;
+        return TRUE;
+    }
+    return FALSE;
+}
+
+/* Check if consumer made no progress since given time */
+static BOOL isWaitTimedOut(const struct timespec *pProgressTime)
+{
+    struct timespec nowTime;
+
+    clock_gettime(CLOCK_MONOTONIC, &nowTime);
+    return ((nowTime.tv_sec - pProgressTime->tv_sec) >= PRODUCER_WAIT_TIMEOUT_SEC) ? TRUE : FALSE;
+}
+
+int main(int argc, const char * argv[])
+{
+    struct timespec waitTime = {0, PRODUCER_SLEEP_NSEC};
+    struct timespec progressTime;
+    TELECMD_SHM_RING_t *pRing = NULL;
+    FILE *pCmdFile = NULL;
+    BOOL isEndOfFile = FALSE;
+    int exitCode = 0;
+
+    if ((argc < 2) || (argc > 3))
+    {
+        printf("usage: telecmdShmProducer /ringName [batchFile]\n");
+        return 1;
+    }
+
+    pCmdFile = fopen((argc == 3) ? argv[2] : "CMD.bat", "r");
+    if (pCmdFile == NULL)
+    {
+        printf("ERROR: Failed to open telecommand file\n");
+        return 1;
+    }
+
+    pRing = telecmdShmRingCreate(argv[1], PRODUCER_RING_CAPACITY);
+    if (pRing == NULL)
+    {
+        fclose(pCmdFile);
+        return 1;
+    }
+
+    /* Fill free records in place and publish them batch by batch */
+    clock_gettime(CLOCK_MONOTONIC, &progressTime);
+    while ((isEndOfFile == FALSE) && (exitCode == 0))
+    {
+        TELECMD_CONFIG_t *pCmdRecords = NULL;
+        UINT32 numOfRecords = telecmdShmRingReserve(pRing, &pCmdRecords, PRODUCER_BATCH_SIZE);
+        UINT32 numOfFilled = 0;
+
+        if (numOfRecords == 0)
+        {
+            /* Ring is full, wait for consumer */
+            if (isWaitTimedOut(&progressTime) == TRUE)
+            {
+                printf("ERROR: Consumer does not take telecommands from the ring\n");
+                exitCode = 1;
+            }
+            nanosleep(&waitTime, NULL);
+            continue;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &progressTime);
+
+        while ((numOfFilled < numOfRecords) &&
+               (readNextCmdRecord(pCmdFile, &pCmdRecords[numOfFilled]) == TRUE))
+        {
+            numOfFilled++;
+        }
+        isEndOfFile = (numOfFilled < numOfRecords) ? TRUE : FALSE;
+        telecmdShmRingPublish(pRing, numOfFilled);
+    }
+    fclose(pCmdFile);
+    telecmdShmRingClose(pRing);
+
+    /* Name is removed only once consumer took everything, so a consumer
+     * attaching late still finds the ring */
+    clock_gettime(CLOCK_MONOTONIC, &progressTime);
+    while ((exitCode == 0) && (telecmdShmRingIsDrained(pRing) == FALSE))
+    {
+        if (isWaitTimedOut(&progressTime) == TRUE)
+        {
+            printf("ERROR: Consumer did not drain the ring\n");
+            exitCode = 1;
+        }
+        nanosleep(&waitTime, NULL);
+    }
+
+    telecmdShmRingDetach(pRing);
+    telecmdShmRingUnlink(argv[1]);
+    return exitCode;
+}
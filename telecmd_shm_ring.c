@@ -0,0 +1,417 @@
+/**
+ * @file telecmd_shm_ring.c
+ *
+ * @brief Shared memory ring Source Code. This file is responsible for create,
+ * attach and batch handling of the POSIX shared memory telecommand ring.
+ *
+ * @author Abhay Gojiya
+ * Contact: abhaygojiya@gmail.com
+ *
+ */
+
+/* System includes */
+#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* Custom includes */
+#include "telecmd_shm_ring.h"
+
+/* Defines and Data Types */
+#define INVALID_VAL     0
+#define SHM_FILE_MODE   0600
+
+/* Function Prototypes */
+static size_t getSizeOfShmRing(UINT32 capacity);
+
+/* Function Definitions */
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: telecmdShmRingCreate()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will create (or recreate) the named shared memory
+ *           object, size it for given number of records, map it and
+ *           initialise the ring header. Called by producer.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    Ring name (e.g. "/telecmd"), capacity (power of 2)
+ *              OUT:   None
+ * RETURN VALUE: Mapped ring, NULL on failure
+ *------------------------------------------------------------------------------
+ * GLOBALS: -
+ *
+ *----------------------------------------------------------------------------*/
+TELECMD_SHM_RING_t *telecmdShmRingCreate(const CHAR *pRingName, UINT32 capacity)
+{
+    TELECMD_SHM_RING_t *pRing = NULL; /* mapped ring */
+    size_t sizeOfRing = INVALID_VAL;  /* size of shared memory object */
+    INT32 shmFd = -1;                 /* shared memory file descriptor */
+
+    /* Capacity must be power of 2 so slots can be masked */
+    if ((capacity == INVALID_VAL) || ((capacity & (capacity - 1)) != INVALID_VAL))
+    {
+        printf("ERROR: telecmdShmRingCreate: Capacity must be power of 2\n");
+        return NULL;
+    }
+
+    sizeOfRing = getSizeOfShmRing(capacity);
+    shmFd = shm_open(pRingName, O_CREAT | O_RDWR | O_TRUNC, SHM_FILE_MODE);
+    if (shmFd < 0)
+    {
+        printf("ERROR: telecmdShmRingCreate: Failed to open shared memory\n");
+        return NULL;
+    }
+
+    if (ftruncate(shmFd, (off_t) sizeOfRing) != 0)
+    {
+        printf("ERROR: telecmdShmRingCreate: Failed to size shared memory\n");
+        close(shmFd);
+        return NULL;
+    }
+
+    pRing = mmap(NULL, sizeOfRing, PROT_READ | PROT_WRITE, MAP_SHARED, shmFd, 0);
+    close(shmFd);
+    if (pRing == MAP_FAILED)
+    {
+        printf("ERROR: telecmdShmRingCreate: Failed to map shared memory\n");
+        return NULL;
+    }
+
+    pRing->capacity = capacity;
+    pRing->producerPid = (INT32) getpid();
+    atomic_init(&pRing->isClosed, FALSE);
+    atomic_init(&pRing->writeIdx, INVALID_VAL);
+    atomic_init(&pRing->readIdx, INVALID_VAL);
+    /* Magic is written last, consumer checks it before using the ring */
+    atomic_thread_fence(memory_order_release);
+    pRing->magic = TELECMD_SHM_RING_MAGIC;
+
+    return pRing;
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: telecmdShmRingOpen()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will attach to an existing ring created by
+ *           producer and validate its header. Called by consumer. A ring
+ *           which does not exist yet (errno ENOENT) or is not initialised
+ *           yet (errno EAGAIN) fails silently, so caller can retry.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    Ring name
+ *              OUT:   None
+ * RETURN VALUE: Mapped ring, NULL on failure
+ *------------------------------------------------------------------------------
+ * GLOBALS: -
+ *
+ *----------------------------------------------------------------------------*/
+TELECMD_SHM_RING_t *telecmdShmRingOpen(const CHAR *pRingName)
+{
+    TELECMD_SHM_RING_t *pRing = NULL; /* mapped ring */
+    struct stat shmStat;              /* status of shared memory object */
+    size_t sizeOfRing = INVALID_VAL;  /* size of ring as per its header */
+    INT32 shmFd = -1;                 /* shared memory file descriptor */
+
+    shmFd = shm_open(pRingName, O_RDWR, SHM_FILE_MODE);
+    if (shmFd < 0)
+    {
+        if (errno != ENOENT)
+        {
+            printf("ERROR: telecmdShmRingOpen: Failed to open shared memory\n");
+        }
+        return NULL;
+    }
+
+    if (fstat(shmFd, &shmStat) != 0)
+    {
+        printf("ERROR: telecmdShmRingOpen: Invalid shared memory size\n");
+        close(shmFd);
+        return NULL;
+    }
+    if ((size_t) shmStat.st_size < sizeof(TELECMD_SHM_RING_t))
+    {
+        /* Producer has not sized the object yet */
+        close(shmFd);
+        errno = EAGAIN;
+        return NULL;
+    }
+
+    /* Map the header first to learn the capacity */
+    pRing = mmap(NULL, sizeof(TELECMD_SHM_RING_t), PROT_READ, MAP_SHARED, shmFd, 0);
+    if (pRing == MAP_FAILED)
+    {
+        printf("ERROR: telecmdShmRingOpen: Failed to map shared memory\n");
+        close(shmFd);
+        return NULL;
+    }
+
+    /* Producer writes magic last, fresh object is all zero until then */
+    if (pRing->magic == INVALID_VAL)
+    {
+        munmap(pRing, sizeof(TELECMD_SHM_RING_t));
+        close(shmFd);
+        errno = EAGAIN;
+        return NULL;
+    }
+    atomic_thread_fence(memory_order_acquire);
+
+    /* Check magic, capacity as producer requires it and that the object
+     * covers all the records */
+    if ((pRing->magic != TELECMD_SHM_RING_MAGIC) ||
+        (pRing->capacity == INVALID_VAL) ||
+        ((pRing->capacity & (pRing->capacity - 1)) != INVALID_VAL) ||
+        (getSizeOfShmRing(pRing->capacity) > (size_t) shmStat.st_size))
+    {
+        printf("ERROR: telecmdShmRingOpen: Invalid ring header\n");
+        munmap(pRing, sizeof(TELECMD_SHM_RING_t));
+        close(shmFd);
+        errno = EINVAL;
+        return NULL;
+    }
+    sizeOfRing = getSizeOfShmRing(pRing->capacity);
+    munmap(pRing, sizeof(TELECMD_SHM_RING_t));
+
+    /* Map exactly the ring size, so detach unmaps what was mapped */
+    pRing = mmap(NULL, sizeOfRing, PROT_READ | PROT_WRITE, MAP_SHARED, shmFd, 0);
+    close(shmFd);
+    if (pRing == MAP_FAILED)
+    {
+        printf("ERROR: telecmdShmRingOpen: Failed to map shared memory\n");
+        return NULL;
+    }
+    atomic_thread_fence(memory_order_acquire);
+
+    return pRing;
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: telecmdShmRingReserve()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will give the producer a contiguous run of free
+ *           records to fill in place. Run stops at the end of ring memory,
+ *           so a wrapping batch needs two reservations.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    Ring, maximum number of records wanted
+ *              OUT:   Address of first free record
+ * RETURN VALUE: Number of reserved records (0 if ring is full)
+ *------------------------------------------------------------------------------
+ * GLOBALS: -
+ *
+ *----------------------------------------------------------------------------*/
+UINT32 telecmdShmRingReserve(TELECMD_SHM_RING_t *pRing, TELECMD_CONFIG_t **ppRecords, UINT32 maxCount)
+{
+    UINT64 writeIdx = atomic_load_explicit(&pRing->writeIdx, memory_order_relaxed);
+    UINT64 readIdx  = atomic_load_explicit(&pRing->readIdx, memory_order_acquire);
+    UINT32 slotIdx  = (UINT32) (writeIdx & (pRing->capacity - 1));
+    UINT32 freeCount = pRing->capacity - (UINT32) (writeIdx - readIdx);
+
+    /* Limit to free records and to end of ring memory */
+    if (freeCount > pRing->capacity - slotIdx)
+    {
+        freeCount = pRing->capacity - slotIdx;
+    }
+    if (freeCount > maxCount)
+    {
+        freeCount = maxCount;
+    }
+
+    *ppRecords = &pRing->records[slotIdx];
+    return freeCount;
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: telecmdShmRingPublish()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will make reserved and filled records visible to
+ *           the consumer.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    Ring, number of filled records
+ *              OUT:   None
+ *------------------------------------------------------------------------------
+ * GLOBALS: -
+ *
+ *----------------------------------------------------------------------------*/
+VOID telecmdShmRingPublish(TELECMD_SHM_RING_t *pRing, UINT32 count)
+{
+    atomic_fetch_add_explicit(&pRing->writeIdx, count, memory_order_release);
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: telecmdShmRingClose()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will mark end of stream. Consumer stops once all
+ *           published records are consumed.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    Ring
+ *              OUT:   None
+ *------------------------------------------------------------------------------
+ * GLOBALS: -
+ *
+ *----------------------------------------------------------------------------*/
+VOID telecmdShmRingClose(TELECMD_SHM_RING_t *pRing)
+{
+    atomic_store_explicit(&pRing->isClosed, TRUE, memory_order_release);
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: telecmdShmRingUnlink()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will remove the name of shared memory object.
+ *           Memory is released once both sides are detached.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    Ring name
+ *              OUT:   None
+ *------------------------------------------------------------------------------
+ * GLOBALS: -
+ *
+ *----------------------------------------------------------------------------*/
+VOID telecmdShmRingUnlink(const CHAR *pRingName)
+{
+    shm_unlink(pRingName);
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: telecmdShmRingAcquire()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will give the consumer a contiguous run of
+ *           published records to process in place.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    Ring
+ *              OUT:   Address of first published record
+ * RETURN VALUE: Number of acquired records (0 if ring is empty)
+ *------------------------------------------------------------------------------
+ * GLOBALS: -
+ *
+ *----------------------------------------------------------------------------*/
+UINT32 telecmdShmRingAcquire(TELECMD_SHM_RING_t *pRing, TELECMD_CONFIG_t **ppRecords)
+{
+    UINT64 readIdx  = atomic_load_explicit(&pRing->readIdx, memory_order_relaxed);
+    UINT64 writeIdx = atomic_load_explicit(&pRing->writeIdx, memory_order_acquire);
+    UINT32 slotIdx  = (UINT32) (readIdx & (pRing->capacity - 1));
+    UINT32 usedCount = (UINT32) (writeIdx - readIdx);
+
+    /* Limit to end of ring memory */
+    if (usedCount > pRing->capacity - slotIdx)
+    {
+        usedCount = pRing->capacity - slotIdx;
+    }
+
+    *ppRecords = &pRing->records[slotIdx];
+    return usedCount;
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: telecmdShmRingRelease()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will give consumed records back to the producer.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    Ring, number of consumed records
+ *              OUT:   None
+ *------------------------------------------------------------------------------
+ * GLOBALS: -
+ *
+ *----------------------------------------------------------------------------*/
+VOID telecmdShmRingRelease(TELECMD_SHM_RING_t *pRing, UINT32 count)
+{
+    atomic_fetch_add_explicit(&pRing->readIdx, count, memory_order_release);
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: telecmdShmRingIsDrained()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will check if producer closed the ring and all
+ *           published records are consumed.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    Ring
+ *              OUT:   None
+ * RETURN VALUE: TRUE if no more records will arrive, else FALSE
+ *------------------------------------------------------------------------------
+ * GLOBALS: -
+ *
+ *----------------------------------------------------------------------------*/
+BOOL telecmdShmRingIsDrained(TELECMD_SHM_RING_t *pRing)
+{
+    /* Closed flag is checked first, all records published before it are
+     * visible when write index is read afterwards */
+    if (atomic_load_explicit(&pRing->isClosed, memory_order_acquire) == FALSE)
+    {
+        return FALSE;
+    }
+
+    return (atomic_load_explicit(&pRing->writeIdx, memory_order_acquire) ==
+            atomic_load_explicit(&pRing->readIdx, memory_order_relaxed)) ? TRUE : FALSE;
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: telecmdShmRingIsProducerAlive()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will check if producer process of the ring still
+ *           exists, so consumer does not wait forever on a ring whose
+ *           producer died without closing it. Both sides must run in the
+ *           same PID namespace.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    Ring
+ *              OUT:   None
+ * RETURN VALUE: FALSE if producer process is gone, else TRUE
+ *------------------------------------------------------------------------------
+ * GLOBALS: -
+ *
+ *----------------------------------------------------------------------------*/
+BOOL telecmdShmRingIsProducerAlive(TELECMD_SHM_RING_t *pRing)
+{
+    /* Signal 0 only checks existence, EPERM still means process exists */
+    if ((kill((pid_t) pRing->producerPid, 0) != 0) && (errno == ESRCH))
+    {
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: telecmdShmRingDetach()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will unmap the ring from the process. Create and
+ *           Open both map exactly the size given by ring capacity.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    Ring
+ *              OUT:   None
+ *------------------------------------------------------------------------------
+ * GLOBALS: -
+ *
+ *----------------------------------------------------------------------------*/
+VOID telecmdShmRingDetach(TELECMD_SHM_RING_t *pRing)
+{
+    munmap(pRing, getSizeOfShmRing(pRing->capacity));
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: getSizeOfShmRing()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will calculate size of shared memory object for
+ *           given number of records.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    Capacity of ring
+ *              OUT:   None
+ * RETURN VALUE: Size in bytes
+ *------------------------------------------------------------------------------
+ * GLOBALS: -
+ *
+ *----------------------------------------------------------------------------*/
+static size_t getSizeOfShmRing(UINT32 capacity)
+{
+    return sizeof(TELECMD_SHM_RING_t) + ((size_t) capacity * sizeof(TELECMD_CONFIG_t));
+}
@@ -0,0 +1,60 @@
+/**
+ * @file telecmd_shm_ring.h
+ *
+ * @brief Shared memory ring for telecommand ingestion. Single producer
+ *        (ground station front end) writes fixed size TELECMD_CONFIG_t
+ *        records in place, single consumer (telecommand interpreter) reads
+ *        them in place. Reserve/Publish and Acquire/Release work on batches
+ *        and only touch the shared indices, no syscalls on the data path.
+ *
+ * @author Abhay Gojiya
+ * Contact: abhaygojiya@gmail.com
+ *
+ */
+
+#ifndef telecmd_shm_ring_h
+#define telecmd_shm_ring_h
+
+#include <stdatomic.h>
+#include "telecmd_typeDef.h"
+#include "telecmd_interpreter.h"
+
+#define TELECMD_SHM_RING_MAGIC      0x544D4352u /* "TCMR" */
+#define TELECMD_SHM_CACHE_LINE      64
+
+/* Shared memory ring layout, records follow the header */
+typedef struct
+{
+    UINT32                      magic;          // TELECMD_SHM_RING_MAGIC
+    UINT32                      capacity;       // Number of records, power of 2
+    _Atomic UINT32              isClosed;       // Producer finished writing
+    INT32                       producerPid;    // Producer process, for liveness check
+
+    /* Indices are free running, slot = idx & (capacity - 1) */
+    _Alignas(TELECMD_SHM_CACHE_LINE)
+    _Atomic UINT64              writeIdx;       // Owned by producer
+    _Alignas(TELECMD_SHM_CACHE_LINE)
+    _Atomic UINT64              readIdx;        // Owned by consumer
+
+    _Alignas(TELECMD_SHM_CACHE_LINE)
+    TELECMD_CONFIG_t            records[];      // Telecommand records
+}TELECMD_SHM_RING_t;
+
+/* Producer side */
+TELECMD_SHM_RING_t *telecmdShmRingCreate(const CHAR *pRingName, UINT32 capacity);
+UINT32 telecmdShmRingReserve(TELECMD_SHM_RING_t *pRing, TELECMD_CONFIG_t **ppRecords, UINT32 maxCount);
+VOID telecmdShmRingPublish(TELECMD_SHM_RING_t *pRing, UINT32 count);
+VOID telecmdShmRingClose(TELECMD_SHM_RING_t *pRing);
+VOID telecmdShmRingUnlink(const CHAR *pRingName);
+
+/* Consumer side */
+TELECMD_SHM_RING_t *telecmdShmRingOpen(const CHAR *pRingName);
+UINT32 telecmdShmRingAcquire(TELECMD_SHM_RING_t *pRing, TELECMD_CONFIG_t **ppRecords);
+VOID telecmdShmRingRelease(TELECMD_SHM_RING_t *pRing, UINT32 count);
+BOOL telecmdShmRingIsDrained(TELECMD_SHM_RING_t *pRing);
+BOOL telecmdShmRingIsProducerAlive(TELECMD_SHM_RING_t *pRing);
+
+/* Both sides */
+VOID telecmdShmRingDetach(TELECMD_SHM_RING_t *pRing);
+
+#endif /* telecmd_shm_ring_h */
@@ -0,0 +1,427 @@
+/**
+ * @file telecmd_thread_pool.c
+ *
+ * @brief Work stealing thread pool Source Code. This file is responsible for
+ * keeping the worker threads parked between batches and running a batch of
+ * tasks on them until all tasks are done.
+ *
+ * @author Abhay Gojiya
+ * Contact: abhaygojiya@gmail.com
+ *
+ */
+
+/* System includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+
+/* Custom includes */
+#include "telecmd_interpreter.h"
+#include "telecmd_thread_pool.h"
+
+/* Defines and Data Types */
+#define INVALID_VAL     0
+
+/* Deque of one worker slot, tasks [topIdx, bottomIdx) of the task array */
+typedef struct
+{
+    pthread_mutex_t     dequeLock;      /* protects the indices */
+    UINT32              topIdx;         /* thieves take from here */
+    UINT32              bottomIdx;      /* owner takes from here */
+}WORKER_DEQUE_t;
+
+/* Shared state of one batch, lives on stack of the submitting thread */
+typedef struct poolBatch
+{
+    TELECMD_TASK_t      *pTasks;        /* tasks of the batch */
+    WORKER_DEQUE_t      *pDeques;       /* one deque per worker slot */
+    UINT32              numOfSlots;     /* worker slots of the batch */
+    UINT32              nextSlotIdx;    /* slot of next joining pool thread */
+    UINT32              numOfHelpers;   /* pool threads working on the batch */
+    BOOL                isOpen;         /* pool threads may still join */
+    struct poolBatch    *pNextBatch;    /* next open batch */
+}POOL_BATCH_t;
+
+/* Static Variables */
+static pthread_once_t poolOnce = PTHREAD_ONCE_INIT; /* starts pool on first use */
+static pthread_mutex_t poolLock = PTHREAD_MUTEX_INITIALIZER; /* protects below */
+static pthread_cond_t batchReady = PTHREAD_COND_INITIALIZER; /* batch was opened */
+static pthread_cond_t batchDone = PTHREAD_COND_INITIALIZER; /* helper left batch */
+static POOL_BATCH_t *pOpenBatches = NULL; /* batches waiting for helpers */
+static BOOL isPoolStopped = FALSE; /* pool threads shall exit */
+static pthread_t poolThreads[TELECMD_MAX_WORKERS]; /* parked workers */
+static UINT32 numOfPoolThreads = INVALID_VAL; /* started pool threads */
+
+/* Function Prototypes */
+static VOID startPoolThreads(VOID);
+static VOID stopPoolThreads(VOID);
+static VOIDPTR runPoolThread(VOIDPTR pThreadArg);
+static VOID closePoolBatch(POOL_BATCH_t *pBatch);
+static VOID runBatchTasks(POOL_BATCH_t *pBatch, UINT32 slotIdx);
+static BOOL popOwnTask(WORKER_DEQUE_t *pDeque, UINT32 *pTaskIdx);
+static BOOL stealTask(WORKER_DEQUE_t *pDeque, UINT32 *pTaskIdx);
+
+/* Function Definitions */
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: telecmdPoolGetNumOfWorkers()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will return number of workers to use, which is
+ *           TELECMD_WORKERS environment variable if set, else number of
+ *           online cores, limited to TELECMD_MAX_WORKERS. Same inside a
+ *           task, nested batch is helped by pool threads as they get free.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    None
+ *              OUT:   None
+ * RETURN VALUE: Number of workers (at least 1)
+ *------------------------------------------------------------------------------
+ * GLOBALS: -
+ *
+ *----------------------------------------------------------------------------*/
+UINT32 telecmdPoolGetNumOfWorkers(VOID)
+{
+    const CHAR *pWorkersEnv = getenv(TELECMD_WORKERS_ENV); /* user setting */
+    long numOfCores = sysconf(_SC_NPROCESSORS_ONLN); /* online cores */
+
+    if (pWorkersEnv != NULL)
+    {
+        numOfCores = strtol(pWorkersEnv, NULL, 10);
+    }
+
+    if (numOfCores < 1)
+    {
+        return 1;
+    }
+    if (numOfCores > TELECMD_MAX_WORKERS)
+    {
+        return TELECMD_MAX_WORKERS;
+    }
+    return (UINT32) numOfCores;
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: telecmdPoolRunTasks()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will run all the tasks of the batch and return once
+ *           all of them are done. Tasks are dealt in contiguous blocks to the
+ *           worker slot deques, caller thread works on slot 0 and parked
+ *           pool threads are woken to join. Pool threads are started once,
+ *           on first use, and stay parked between batches. Tasks of the
+ *           batch must be independent of each other. A task may run its own
+ *           nested batch, free pool threads join the newest batch first.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    Task array, number of tasks, number of workers
+ *              OUT:   None
+ *------------------------------------------------------------------------------
+ * GLOBALS: pOpenBatches (batches waiting for helpers)
+ *
+ *----------------------------------------------------------------------------*/
+VOID telecmdPoolRunTasks(TELECMD_TASK_t *pTasks, UINT32 numOfTasks, UINT32 numOfWorkers)
+{
+    WORKER_DEQUE_t workerDeques[TELECMD_MAX_WORKERS];   /* deque per slot */
+    POOL_BATCH_t poolBatch = {pTasks, workerDeques, INVALID_VAL, 1, INVALID_VAL, FALSE, NULL};
+    UINT32 slotIdx = INVALID_VAL; /* loop var for slots */
+    UINT32 taskIdx = INVALID_VAL; /* loop var for tasks */
+
+    if (numOfWorkers > TELECMD_MAX_WORKERS)
+    {
+        numOfWorkers = TELECMD_MAX_WORKERS;
+    }
+    if (numOfWorkers > numOfTasks)
+    {
+        numOfWorkers = numOfTasks;
+    }
+    if (numOfWorkers > 1)
+    {
+        pthread_once(&poolOnce, startPoolThreads);
+    }
+
+    /* Nothing to share, or no pool thread could be started */
+    if ((numOfWorkers <= 1) || (numOfPoolThreads == INVALID_VAL))
+    {
+        for (taskIdx = 0; taskIdx < numOfTasks; taskIdx++)
+        {
+            pTasks[taskIdx].pTaskFn(pTasks[taskIdx].pTaskArg);
+        }
+        return;
+    }
+
+    /* Deal the tasks in contiguous blocks so owner works on neighbours */
+    for (slotIdx = 0; slotIdx < numOfWorkers; slotIdx++)
+    {
+        pthread_mutex_init(&workerDeques[slotIdx].dequeLock, NULL);
+        workerDeques[slotIdx].topIdx =
+            (UINT32) (((UINT64) numOfTasks * slotIdx) / numOfWorkers);
+        workerDeques[slotIdx].bottomIdx =
+            (UINT32) (((UINT64) numOfTasks * (slotIdx + 1)) / numOfWorkers);
+    }
+    poolBatch.numOfSlots = numOfWorkers;
+
+    /* Open the batch and wake parked pool threads */
+    pthread_mutex_lock(&poolLock);
+    poolBatch.isOpen = TRUE;
+    poolBatch.pNextBatch = pOpenBatches;
+    pOpenBatches = &poolBatch;
+    pthread_cond_broadcast(&batchReady);
+    pthread_mutex_unlock(&poolLock);
+
+    runBatchTasks(&poolBatch, 0);
+
+    /* All tasks are taken, wait for helpers still running their last one */
+    pthread_mutex_lock(&poolLock);
+    closePoolBatch(&poolBatch);
+    while (poolBatch.numOfHelpers != INVALID_VAL)
+    {
+        pthread_cond_wait(&batchDone, &poolLock);
+    }
+    pthread_mutex_unlock(&poolLock);
+
+    for (slotIdx = 0; slotIdx < numOfWorkers; slotIdx++)
+    {
+        pthread_mutex_destroy(&workerDeques[slotIdx].dequeLock);
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: startPoolThreads()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will start one pool thread less than configured
+ *           workers, submitting thread is the remaining worker. Pool threads
+ *           are stopped at process exit.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    None
+ *              OUT:   None
+ *------------------------------------------------------------------------------
+ * GLOBALS: poolThreads (parked workers)
+ *          numOfPoolThreads (started pool threads)
+ *----------------------------------------------------------------------------*/
+static VOID startPoolThreads(VOID)
+{
+    UINT32 numOfThreads = telecmdPoolGetNumOfWorkers() - 1; /* wanted threads */
+
+    while (numOfPoolThreads < numOfThreads)
+    {
+        if (pthread_create(&poolThreads[numOfPoolThreads], NULL, runPoolThread, NULL) != 0)
+        {
+            /* Not fatal, batches run on the threads started so far */
+            fprintf(TELECMD_OUT, "ERROR: telecmdPoolRunTasks: Failed to start worker\n");
+            break;
+        }
+        numOfPoolThreads++;
+    }
+    if (numOfPoolThreads != INVALID_VAL)
+    {
+        atexit(stopPoolThreads);
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: stopPoolThreads()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will wake all parked pool threads and wait until
+ *           they exit.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    None
+ *              OUT:   None
+ *------------------------------------------------------------------------------
+ * GLOBALS: isPoolStopped (pool threads shall exit)
+ *          poolThreads (parked workers)
+ *----------------------------------------------------------------------------*/
+static VOID stopPoolThreads(VOID)
+{
+    UINT32 threadIdx = INVALID_VAL; /* loop var for pool threads */
+
+    pthread_mutex_lock(&poolLock);
+    isPoolStopped = TRUE;
+    pthread_cond_broadcast(&batchReady);
+    pthread_mutex_unlock(&poolLock);
+
+    for (threadIdx = 0; threadIdx < numOfPoolThreads; threadIdx++)
+    {
+        pthread_join(poolThreads[threadIdx], NULL);
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: runPoolThread()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function is the loop of a pool thread. It parks until a
+ *           batch is opened, takes next worker slot of the batch and works
+ *           on it until all its tasks are taken. A batch is closed for
+ *           joining once all its slots are taken or its tasks are gone.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    Unused
+ *              OUT:   None
+ * RETURN VALUE: NULL
+ *------------------------------------------------------------------------------
+ * GLOBALS: pOpenBatches (batches waiting for helpers)
+ *          isPoolStopped (pool threads shall exit)
+ *----------------------------------------------------------------------------*/
+static VOIDPTR runPoolThread(VOIDPTR pThreadArg)
+{
+    (VOID) pThreadArg;
+
+    pthread_mutex_lock(&poolLock);
+    while (TRUE)
+    {
+        POOL_BATCH_t *pBatch = pOpenBatches; /* newest open batch */
+        UINT32 slotIdx = INVALID_VAL; /* worker slot in the batch */
+
+        if (isPoolStopped == TRUE)
+        {
+            break;
+        }
+        if (pBatch == NULL)
+        {
+            pthread_cond_wait(&batchReady, &poolLock);
+            continue;
+        }
+
+        slotIdx = pBatch->nextSlotIdx++;
+        if (pBatch->nextSlotIdx == pBatch->numOfSlots)
+        {
+            closePoolBatch(pBatch);
+        }
+        pBatch->numOfHelpers++;
+        pthread_mutex_unlock(&poolLock);
+
+        runBatchTasks(pBatch, slotIdx);
+
+        pthread_mutex_lock(&poolLock);
+        closePoolBatch(pBatch);
+        pBatch->numOfHelpers--;
+        if (pBatch->numOfHelpers == INVALID_VAL)
+        {
+            pthread_cond_broadcast(&batchDone);
+        }
+    }
+    pthread_mutex_unlock(&poolLock);
+    return NULL;
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: closePoolBatch()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will remove the batch from open batches, so no
+ *           more pool threads join it. Called with pool lock held.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    Address of batch
+ *              OUT:   None
+ *------------------------------------------------------------------------------
+ * GLOBALS: pOpenBatches (batches waiting for helpers)
+ *
+ *----------------------------------------------------------------------------*/
+static VOID closePoolBatch(POOL_BATCH_t *pBatch)
+{
+    POOL_BATCH_t **ppLink = &pOpenBatches; /* link pointing to the batch */
+
+    if (pBatch->isOpen == FALSE)
+    {
+        return;
+    }
+    while (*ppLink != pBatch)
+    {
+        ppLink = &(*ppLink)->pNextBatch;
+    }
+    *ppLink = pBatch->pNextBatch;
+    pBatch->isOpen = FALSE;
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: runBatchTasks()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will run tasks from own slot deque and steal from
+ *           other deques when own is empty. Tasks never add new tasks, so
+ *           worker is done once all deques are empty.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    Address of batch, worker slot
+ *              OUT:   None
+ *------------------------------------------------------------------------------
+ * GLOBALS: -
+ *
+ *----------------------------------------------------------------------------*/
+static VOID runBatchTasks(POOL_BATCH_t *pBatch, UINT32 slotIdx)
+{
+    UINT32 taskIdx = INVALID_VAL; /* task to run */
+
+    while (TRUE)
+    {
+        BOOL isTaskFound = popOwnTask(&pBatch->pDeques[slotIdx], &taskIdx);
+        UINT32 victimCount = INVALID_VAL; /* loop var for other slots */
+
+        /* Own deque is empty, try other slots starting from next one */
+        for (victimCount = 1; (isTaskFound == FALSE) && (victimCount < pBatch->numOfSlots); victimCount++)
+        {
+            UINT32 victimIdx = (slotIdx + victimCount) % pBatch->numOfSlots;
+            isTaskFound = stealTask(&pBatch->pDeques[victimIdx], &taskIdx);
+        }
+
+        if (isTaskFound == FALSE)
+        {
+            break;
+        }
+        pBatch->pTasks[taskIdx].pTaskFn(pBatch->pTasks[taskIdx].pTaskArg);
+    }
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: popOwnTask()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will take task from bottom of own deque.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    Address of deque
+ *              OUT:   Task index
+ * RETURN VALUE: TRUE if task is taken, else FALSE
+ *------------------------------------------------------------------------------
+ * GLOBALS: -
+ *
+ *----------------------------------------------------------------------------*/
+static BOOL popOwnTask(WORKER_DEQUE_t *pDeque, UINT32 *pTaskIdx)
+{
+    BOOL isTaskFound = FALSE;
+
+    pthread_mutex_lock(&pDeque->dequeLock);
+    if (pDeque->topIdx < pDeque->bottomIdx)
+    {
+        *pTaskIdx = --pDeque->bottomIdx;
+        isTaskFound = TRUE;
+    }
+    pthread_mutex_unlock(&pDeque->dequeLock);
+    return isTaskFound;
+}
+
+/*------------------------------------------------------------------------------
+ * FUNCTION: stealTask()
+ *------------------------------------------------------------------------------
+ * ABSTRACT: This function will take task from top of other worker's deque.
+ *------------------------------------------------------------------------------
+ * PARAMETERS:
+ *              IN:    Address of victim deque
+ *              OUT:   Task index
+ * RETURN VALUE: TRUE if task is taken, else FALSE
+ *------------------------------------------------------------------------------
+ * GLOBALS: -
+ *
+ *----------------------------------------------------------------------------*/
+static BOOL stealTask(WORKER_DEQUE_t *pDeque, UINT32 *pTaskIdx)
+{
+    BOOL isTaskFound = FALSE;
+
+    pthread_mutex_lock(&pDeque->dequeLock);
+    if (pDeque->topIdx < pDeque->bottomIdx)
+    {
+        *pTaskIdx = pDeque->topIdx++;
+        isTaskFound = TRUE;
+    }
+    pthread_mutex_unlock(&pDeque->dequeLock);
+    return isTaskFound;
+}
@@ -0,0 +1,35 @@
+/**
+ * @file telecmd_thread_pool.h
+ *
+ * @brief Work stealing thread pool header file. A batch of independent tasks
+ *        is spread over per worker deques, worker pops from its own deque
+ *        and steals from others when it runs empty. Worker threads are
+ *        started on first use and stay parked between batches.
+ *
+ * @author Abhay Gojiya
+ * Contact: abhaygojiya@gmail.com
+ *
+ */
+
+#ifndef telecmd_thread_pool_h
+#define telecmd_thread_pool_h
+
+#include "telecmd_typeDef.h"
+
+#define TELECMD_MAX_WORKERS     32
+#define TELECMD_WORKERS_ENV     "TELECMD_WORKERS" /* overrides core count */
+
+/* Task function, called once with its argument */
+typedef VOID (*TELECMD_TASK_FN_t)(VOIDPTR pTaskArg);
+
+/* Task of the pool */
+typedef struct
+{
+    TELECMD_TASK_FN_t   pTaskFn;        // Function to run
+    VOIDPTR             pTaskArg;       // Argument of function
+}TELECMD_TASK_t;
+
+UINT32 telecmdPoolGetNumOfWorkers(VOID);
+VOID telecmdPoolRunTasks(TELECMD_TASK_t *pTasks, UINT32 numOfTasks, UINT32 numOfWorkers);
+
+#endif /* telecmd_thread_pool_h */